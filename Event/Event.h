@@ -3,73 +3,1337 @@
 #include "../../Runtime/Core/Core.h"
 #include <vector>
 #include <algorithm>
+#include <atomic>
 #include <functional>
+#include <mutex>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <utility>
 #include "../../Runtime/Core/Object.h"
 #include "../../Runtime/Engine/PTR.h"
+#include "EventProfiler.h"
 
 namespace Syn
 {
+    /***
+     * How an event parameter reaches listeners. References and scalars pass through unchanged,
+     * any other type is handed out as a const reference so a payload is never copied per listener.
+    **/
+    template <typename T>
+    using EventParam = std::conditional_t<std::is_reference_v<T> || std::is_scalar_v<T>, T, const T&>;
+
+    /** Parameter form used for the last listener of TriggerMoveLast, which may take the payload over */
+    template <typename T>
+    using EventMoveParam = std::conditional_t<std::is_reference_v<T> || std::is_scalar_v<T>, T, T&&>;
+
+    /***
+     * Type-erased listener storage used by Event.
+     * Callables (function pointers, lambdas with captures, functors) are kept in an inline buffer,
+     * so registering and triggering never allocates. Callables bigger than InlineSize are rejected at compile time.
+    **/
+    template <typename... T>
+    class SYN_API EventDelegate
+    {
+    public:
+        static constexpr size_t InlineSize = 32;
+
+    private:
+        struct Operations
+        {
+            bool (*invoke)(void* storage, EventParam<T>... args);
+            bool (*invokeMove)(void* storage, EventMoveParam<T>... args);
+            void (*copy)(void* destination, const void* source);
+            void (*move)(void* destination, void* source);
+            void (*destroy)(void* storage);
+        };
+
+        // Callables returning bool report whether they handled the event, everything else never does
+        template <typename F>
+        static bool InvokeImpl(void* storage, EventParam<T>... args)
+        {
+            if constexpr (std::is_same_v<std::invoke_result_t<F&, EventParam<T>...>, bool>)
+            {
+                return (*static_cast<F*>(storage))(args...);
+            }
+            else
+            {
+                (*static_cast<F*>(storage))(args...);
+                return false;
+            }
+        }
+
+        // Callables that can not take rvalues get the payload as const reference instead
+        template <typename F>
+        static bool InvokeMoveImpl(void* storage, EventMoveParam<T>... args)
+        {
+            if constexpr (!std::is_invocable_v<F&, EventMoveParam<T>...>)
+            {
+                return InvokeImpl<F>(storage, args...);
+            }
+            else if constexpr (std::is_same_v<std::invoke_result_t<F&, EventMoveParam<T>...>, bool>)
+            {
+                return (*static_cast<F*>(storage))(std::forward<EventMoveParam<T>>(args)...);
+            }
+            else
+            {
+                (*static_cast<F*>(storage))(std::forward<EventMoveParam<T>>(args)...);
+                return false;
+            }
+        }
+
+        template <typename F>
+        static void CopyImpl(void* destination, const void* source)
+        {
+            ::new (destination) F(*static_cast<const F*>(source));
+        }
+
+        template <typename F>
+        static void MoveImpl(void* destination, void* source)
+        {
+            ::new (destination) F(std::move(*static_cast<F*>(source)));
+            static_cast<F*>(source)->~F();
+        }
+
+        template <typename F>
+        static void DestroyImpl(void* storage)
+        {
+            static_cast<F*>(storage)->~F();
+        }
+
+        template <typename F>
+        static constexpr Operations OperationsOf = {&InvokeImpl<F>, &InvokeMoveImpl<F>, &CopyImpl<F>, &MoveImpl<F>, &DestroyImpl<F>};
+
+        alignas(std::max_align_t) unsigned char storage[InlineSize];
+        const Operations* operations = nullptr;
+
+    public:
+        EventDelegate() = default;
+
+        template <typename F, typename Decayed = std::decay_t<F>,
+                  typename = std::enable_if_t<!std::is_same_v<Decayed, EventDelegate>>>
+        EventDelegate(F&& Callable)
+        {
+            static_assert(std::is_invocable_v<Decayed&, EventParam<T>...>, "Callable can not be invoked with the event parameters");
+            static_assert(sizeof(Decayed) <= InlineSize, "Callable captures too much state for EventDelegate::InlineSize");
+            static_assert(alignof(Decayed) <= alignof(std::max_align_t), "Callable is over-aligned for EventDelegate");
+            static_assert(std::is_copy_constructible_v<Decayed>, "Callable must be copy constructible");
+
+            ::new (static_cast<void*>(storage)) Decayed(std::forward<F>(Callable));
+            operations = &OperationsOf<Decayed>;
+        }
+
+        EventDelegate(const EventDelegate& Other)
+            : operations(Other.operations)
+        {
+            if (operations != nullptr)
+            {
+                operations->copy(storage, Other.storage);
+            }
+        }
+
+        EventDelegate(EventDelegate&& Other) noexcept
+            : operations(Other.operations)
+        {
+            if (operations != nullptr)
+            {
+                operations->move(storage, Other.storage);
+                Other.operations = nullptr;
+            }
+        }
+
+        EventDelegate& operator=(const EventDelegate& Other)
+        {
+            if (this != &Other)
+            {
+                Reset();
+                if (Other.operations != nullptr)
+                {
+                    Other.operations->copy(storage, Other.storage);
+                    operations = Other.operations;
+                }
+            }
+            return *this;
+        }
+
+        EventDelegate& operator=(EventDelegate&& Other) noexcept
+        {
+            if (this != &Other)
+            {
+                Reset();
+                if (Other.operations != nullptr)
+                {
+                    Other.operations->move(storage, Other.storage);
+                    operations = Other.operations;
+                    Other.operations = nullptr;
+                }
+            }
+            return *this;
+        }
+
+        ~EventDelegate()
+        {
+            Reset();
+        }
+
+        void Reset()
+        {
+            if (operations != nullptr)
+            {
+                operations->destroy(storage);
+                operations = nullptr;
+            }
+        }
+
+        bool IsBound() const
+        {
+            return operations != nullptr;
+        }
+
+        /** Returns the stored callable if it is exactly of type F, nullptr otherwise */
+        template <typename F>
+        const F* Target() const
+        {
+            return operations == &OperationsOf<F> ? reinterpret_cast<const F*>(storage) : nullptr;
+        }
+
+        bool operator ()(EventParam<T>... args)
+        {
+            return operations->invoke(storage, args...);
+        }
+
+        /** Invokes with rvalue payloads, the callable may move from them */
+        bool InvokeMove(EventMoveParam<T>... args)
+        {
+            return operations->invokeMove(storage, std::forward<EventMoveParam<T>>(args)...);
+        }
+    };
+
+    /***
+     * Generation-checked reference to a listener registered on an Event or LinkedEvent.
+     * A handle stays safe to use after its listener is removed, Unregister simply ignores it.
+    **/
+    struct SYN_API EventHandle
+    {
+        static constexpr uint32_t InvalidIndex = 0xFFFFFFFFu;
+
+        uint32_t index = InvalidIndex;
+        uint32_t generation = 0;
+
+        bool IsValid() const
+        {
+            return index != InvalidIndex;
+        }
+
+        bool operator==(const EventHandle& Other) const
+        {
+            return index == Other.index && generation == Other.generation;
+        }
+
+        bool operator!=(const EventHandle& Other) const
+        {
+            return !(*this == Other);
+        }
+    };
+
+    /***
+     * How removed listeners are taken out of the dense array.
+     * SwapAndPop is O(1) per removal but reorders listeners, Stable compacts in one pass and keeps registration order.
+    **/
+    enum class EventCompaction : uint8_t
+    {
+        SwapAndPop,
+        Stable
+    };
+
+    /***
+     * Slot map backing the listener lists.
+     * Listeners live in a dense array that Trigger iterates directly, handles point at a slot
+     * which knows the dense position, so removing by handle is a swap-and-pop instead of a search and shift.
+     *
+     * Listeners may register or unregister while a Dispatch is running. Removals turn the dense entry into
+     * a tombstone that Dispatch skips, additions are parked in a pending list. Both are applied once the
+     * outermost Dispatch returns, so the dense array never moves under a running listener and Trigger needs no copy.
+     * The same path is used to sweep listeners that report themselves dead during DispatchAndSweep.
+     *
+     * Every listener carries a priority, the dense array is kept grouped in buckets of descending priority so
+     * dispatch order needs no sorting. Adding or removing moves at most one entry per bucket (SwapAndPop),
+     * with a single default bucket this is the plain push_back / swap-and-pop.
+    **/
+    template <typename TListener>
+    class SYN_API EventListenerStore
+    {
+    private:
+        static constexpr uint32_t PendingAddFlag = 0x80000000u;
+
+        struct Slot
+        {
+            uint32_t denseIndex = EventHandle::InvalidIndex;
+            uint32_t generation = 0;
+        };
+
+        struct PendingAdd
+        {
+            uint32_t slotIndex;
+            int32_t priority;
+            TListener listener;
+        };
+
+        struct PriorityBucket
+        {
+            int32_t priority;
+            uint32_t begin;
+        };
+
+        struct DispatchScope
+        {
+            EventListenerStore& store;
+
+            explicit DispatchScope(EventListenerStore& InStore)
+                : store(InStore)
+            {
+                ++store.dispatchDepth;
+            }
+
+            ~DispatchScope()
+            {
+                if (--store.dispatchDepth == 0)
+                {
+                    store.ApplyPendingChanges();
+                }
+            }
+        };
+
+        std::vector<TListener> listeners;
+        std::vector<uint32_t> listenerSlots;
+        std::vector<Slot> slots;
+        std::vector<uint32_t> freeSlots;
+        std::vector<PriorityBucket> buckets;
+
+        std::vector<PendingAdd> pendingAdds;
+        std::vector<uint32_t> pendingRemovals;
+        uint32_t dispatchDepth = 0;
+        size_t liveCount = 0;
+        EventCompaction compaction = EventCompaction::SwapAndPop;
+
+        uint32_t AllocateSlot()
+        {
+            if (!freeSlots.empty())
+            {
+                const uint32_t slotIndex = freeSlots.back();
+                freeSlots.pop_back();
+                return slotIndex;
+            }
+
+            slots.emplace_back();
+            return static_cast<uint32_t>(slots.size() - 1);
+        }
+
+        void ReleaseSlot(uint32_t SlotIndex)
+        {
+            slots[SlotIndex].denseIndex = EventHandle::InvalidIndex;
+            ++slots[SlotIndex].generation;
+            freeSlots.push_back(SlotIndex);
+        }
+
+        size_t BucketEnd(size_t Bucket) const
+        {
+            return Bucket + 1 < buckets.size() ? buckets[Bucket + 1].begin : listeners.size();
+        }
+
+        size_t BucketOf(size_t DenseIndex) const
+        {
+            auto found = std::upper_bound(buckets.begin(), buckets.end(), DenseIndex,
+                                          [](size_t Index, const PriorityBucket& Bucket)
+                                          {
+                                              return Index < Bucket.begin;
+                                          });
+            return static_cast<size_t>(found - buckets.begin()) - 1;
+        }
+
+        size_t FindOrAddBucket(int32_t Priority)
+        {
+            auto found = std::lower_bound(buckets.begin(), buckets.end(), Priority,
+                                          [](const PriorityBucket& Bucket, int32_t Value)
+                                          {
+                                              return Bucket.priority > Value;
+                                          });
+            if (found != buckets.end() && found->priority == Priority)
+            {
+                return static_cast<size_t>(found - buckets.begin());
+            }
+
+            const size_t bucket = static_cast<size_t>(found - buckets.begin());
+            const uint32_t begin = found != buckets.end() ? found->begin : static_cast<uint32_t>(listeners.size());
+            buckets.insert(found, PriorityBucket{Priority, begin});
+            return bucket;
+        }
+
+        void RemoveBucketIfEmpty(size_t Bucket)
+        {
+            if (buckets[Bucket].begin == BucketEnd(Bucket))
+            {
+                buckets.erase(buckets.begin() + Bucket);
+            }
+        }
+
+        void MoveEntry(size_t From, size_t To)
+        {
+            listeners[To] = std::move(listeners[From]);
+            listenerSlots[To] = listenerSlots[From];
+            if (listenerSlots[To] != EventHandle::InvalidIndex)
+            {
+                slots[listenerSlots[To]].denseIndex = static_cast<uint32_t>(To);
+            }
+        }
+
+        void SwapEntries(size_t A, size_t B)
+        {
+            std::swap(listeners[A], listeners[B]);
+            std::swap(listenerSlots[A], listenerSlots[B]);
+            if (listenerSlots[A] != EventHandle::InvalidIndex)
+            {
+                slots[listenerSlots[A]].denseIndex = static_cast<uint32_t>(A);
+            }
+            if (listenerSlots[B] != EventHandle::InvalidIndex)
+            {
+                slots[listenerSlots[B]].denseIndex = static_cast<uint32_t>(B);
+            }
+        }
+
+        void Insert(TListener&& Listener, uint32_t SlotIndex, int32_t Priority)
+        {
+            const size_t bucket = FindOrAddBucket(Priority);
+
+            listeners.push_back(std::move(Listener));
+            listenerSlots.push_back(SlotIndex);
+            slots[SlotIndex].denseIndex = static_cast<uint32_t>(listeners.size() - 1);
+
+            size_t hole = listeners.size() - 1;
+            for (size_t next = buckets.size() - 1; next > bucket; --next)
+            {
+                // Stable shifts every later entry, SwapAndPop only hands the first entry of each later bucket to its end
+                const size_t first = buckets[next].begin;
+                if (compaction == EventCompaction::Stable)
+                {
+                    for (size_t index = hole; index > first; --index)
+                    {
+                        SwapEntries(index, index - 1);
+                    }
+                }
+                else if (first != hole)
+                {
+                    SwapEntries(first, hole);
+                }
+                ++buckets[next].begin;
+                hole = first;
+            }
+        }
+
+        /** Removes the entry at DenseIndex, the last entry of its bucket and of every later bucket moves down by one */
+        void SwapAndPop(size_t DenseIndex)
+        {
+            const size_t bucket = BucketOf(DenseIndex);
+
+            size_t hole = DenseIndex;
+            size_t last = BucketEnd(bucket) - 1;
+            if (hole != last)
+            {
+                MoveEntry(last, hole);
+            }
+            hole = last;
+
+            for (size_t next = bucket + 1; next < buckets.size(); ++next)
+            {
+                --buckets[next].begin;
+                last = BucketEnd(next) - 1;
+                if (hole != last)
+                {
+                    MoveEntry(last, hole);
+                }
+                hole = last;
+            }
+
+            listeners.pop_back();
+            listenerSlots.pop_back();
+            RemoveBucketIfEmpty(bucket);
+        }
+
+        void CompactStable()
+        {
+            size_t writeIndex = 0;
+            size_t bucket = 0;
+            for (size_t readIndex = 0; readIndex < listeners.size(); ++readIndex)
+            {
+                while (bucket < buckets.size() && buckets[bucket].begin == readIndex)
+                {
+                    buckets[bucket++].begin = static_cast<uint32_t>(writeIndex);
+                }
+
+                const uint32_t slotIndex = listenerSlots[readIndex];
+                if (slotIndex == EventHandle::InvalidIndex)
+                {
+                    continue;
+                }
+
+                if (writeIndex != readIndex)
+                {
+                    MoveEntry(readIndex, writeIndex);
+                }
+                ++writeIndex;
+            }
+            for (; bucket < buckets.size(); ++bucket)
+            {
+                buckets[bucket].begin = static_cast<uint32_t>(writeIndex);
+            }
+
+            listeners.erase(listeners.begin() + writeIndex, listeners.end());
+            listenerSlots.erase(listenerSlots.begin() + writeIndex, listenerSlots.end());
+
+            for (size_t index = buckets.size(); index-- > 0;)
+            {
+                RemoveBucketIfEmpty(index);
+            }
+        }
+
+        void MarkRemoved(uint32_t DenseIndex)
+        {
+            listenerSlots[DenseIndex] = EventHandle::InvalidIndex;
+            pendingRemovals.push_back(DenseIndex);
+        }
+
+        void ApplyPendingChanges()
+        {
+            if (!pendingRemovals.empty())
+            {
+                if (compaction == EventCompaction::Stable)
+                {
+                    CompactStable();
+                }
+                else
+                {
+                    // Highest index first, so the entry swapped in is never a tombstone still waiting for removal
+                    std::sort(pendingRemovals.begin(), pendingRemovals.end(), std::greater<uint32_t>());
+                    for (uint32_t denseIndex : pendingRemovals)
+                    {
+                        SwapAndPop(denseIndex);
+                    }
+                }
+                pendingRemovals.clear();
+            }
+
+            for (PendingAdd& pending : pendingAdds)
+            {
+                if (pending.slotIndex != EventHandle::InvalidIndex)
+                {
+                    Insert(std::move(pending.listener), pending.slotIndex, pending.priority);
+                }
+            }
+            pendingAdds.clear();
+        }
+
+    public:
+        /** Number of registered listeners, including ones added during the running dispatch */
+        size_t size() const
+        {
+            return liveCount;
+        }
+
+        bool IsDispatching() const
+        {
+            return dispatchDepth > 0;
+        }
+
+        /** Slot index of a listener reached through Dispatch, stable for as long as the listener stays registered */
+        uint32_t SlotOf(const TListener& Listener) const
+        {
+            return listenerSlots[static_cast<size_t>(&Listener - listeners.data())];
+        }
+
+        EventCompaction GetCompaction() const
+        {
+            return compaction;
+        }
+
+        void SetCompaction(EventCompaction InCompaction)
+        {
+            compaction = InCompaction;
+        }
+
+        /** Higher priorities are dispatched first, listeners sharing a priority have no guaranteed order under SwapAndPop */
+        EventHandle Add(TListener&& Listener, int32_t Priority = 0)
+        {
+            const uint32_t slotIndex = AllocateSlot();
+            ++liveCount;
+
+            if (dispatchDepth > 0)
+            {
+                slots[slotIndex].denseIndex = PendingAddFlag | static_cast<uint32_t>(pendingAdds.size());
+                pendingAdds.push_back(PendingAdd{slotIndex, Priority, std::move(Listener)});
+            }
+            else
+            {
+                Insert(std::move(Listener), slotIndex, Priority);
+            }
+
+            return EventHandle{slotIndex, slots[slotIndex].generation};
+        }
+
+        bool Contains(EventHandle Handle) const
+        {
+            return Handle.index < slots.size() &&
+                   slots[Handle.index].generation == Handle.generation &&
+                   slots[Handle.index].denseIndex != EventHandle::InvalidIndex;
+        }
+
+        bool Remove(EventHandle Handle)
+        {
+            if (!Contains(Handle))
+            {
+                return false;
+            }
+
+            const uint32_t denseIndex = slots[Handle.index].denseIndex;
+            if (denseIndex & PendingAddFlag)
+            {
+                pendingAdds[denseIndex & ~PendingAddFlag].slotIndex = EventHandle::InvalidIndex;
+            }
+            else if (dispatchDepth > 0)
+            {
+                MarkRemoved(denseIndex);
+            }
+            else if (compaction == EventCompaction::Stable)
+            {
+                MarkRemoved(denseIndex);
+                ApplyPendingChanges();
+            }
+            else
+            {
+                SwapAndPop(denseIndex);
+            }
+
+            ReleaseSlot(Handle.index);
+            --liveCount;
+            return true;
+        }
+
+        /** Returns the handle of the first live listener matching Predicate, or an invalid handle */
+        template <typename Predicate>
+        EventHandle FindHandle(Predicate&& Pred) const
+        {
+            for (size_t index = 0; index < listeners.size(); ++index)
+            {
+                const uint32_t slotIndex = listenerSlots[index];
+                if (slotIndex != EventHandle::InvalidIndex && Pred(listeners[index]))
+                {
+                    return EventHandle{slotIndex, slots[slotIndex].generation};
+                }
+            }
+            for (const PendingAdd& pending : pendingAdds)
+            {
+                if (pending.slotIndex != EventHandle::InvalidIndex && Pred(pending.listener))
+                {
+                    return EventHandle{pending.slotIndex, slots[pending.slotIndex].generation};
+                }
+            }
+            return EventHandle{};
+        }
+
+        /**
+         * Calls Visit for every live listener in the dense array.
+         * Listeners registered during the dispatch are delivered from the next one on.
+         **/
+        template <typename Visitor>
+        void Dispatch(Visitor&& Visit)
+        {
+            DispatchScope scope(*this);
+
+            const size_t count = listeners.size();
+            for (size_t index = 0; index < count; ++index)
+            {
+                if (listenerSlots[index] != EventHandle::InvalidIndex)
+                {
+                    Visit(listeners[index]);
+                }
+            }
+        }
+
+        /**
+         * Same as Dispatch, but the last live listener is handed to VisitLast instead of Visit.
+         * If that listener is unregistered before its turn, VisitLast is not called.
+         **/
+        template <typename Visitor, typename LastVisitor>
+        void Dispatch(Visitor&& Visit, LastVisitor&& VisitLast)
+        {
+            DispatchScope scope(*this);
+
+            size_t last = listeners.size();
+            while (last > 0 && listenerSlots[last - 1] == EventHandle::InvalidIndex)
+            {
+                --last;
+            }
+            if (last == 0)
+            {
+                return;
+            }
+            --last;
+
+            for (size_t index = 0; index < last; ++index)
+            {
+                if (listenerSlots[index] != EventHandle::InvalidIndex)
+                {
+                    Visit(listeners[index]);
+                }
+            }
+            if (listenerSlots[last] != EventHandle::InvalidIndex)
+            {
+                VisitLast(listeners[last]);
+            }
+        }
+
+        /**
+         * Same as Dispatch, but stops at the first listener for which Visit returns true.
+         * Returns the handle of that listener, or an invalid handle if none did.
+         **/
+        template <typename Visitor>
+        EventHandle DispatchUntil(Visitor&& Visit)
+        {
+            DispatchScope scope(*this);
+
+            const size_t count = listeners.size();
+            for (size_t index = 0; index < count; ++index)
+            {
+                const uint32_t slotIndex = listenerSlots[index];
+                if (slotIndex != EventHandle::InvalidIndex)
+                {
+                    const EventHandle handle{slotIndex, slots[slotIndex].generation};
+                    if (Visit(listeners[index]))
+                    {
+                        return handle;
+                    }
+                }
+            }
+            return EventHandle{};
+        }
+
+        /**
+         * Same as Dispatch, but Visit returns false for listeners that are dead.
+         * Those are unregistered on the spot and swept with the configured compaction once the dispatch ends.
+         * Returns the number of listeners swept.
+         **/
+        template <typename Visitor>
+        size_t DispatchAndSweep(Visitor&& Visit)
+        {
+            DispatchScope scope(*this);
+
+            size_t swept = 0;
+            const size_t count = listeners.size();
+            for (size_t index = 0; index < count; ++index)
+            {
+                const uint32_t slotIndex = listenerSlots[index];
+                if (slotIndex != EventHandle::InvalidIndex && !Visit(listeners[index]))
+                {
+                    MarkRemoved(static_cast<uint32_t>(index));
+                    ReleaseSlot(slotIndex);
+                    --liveCount;
+                    ++swept;
+                }
+            }
+            return swept;
+        }
+    };
+
+    template <typename... T>
+    class SYN_API Event
+    {
+    private:
+        EventListenerStore<EventDelegate<T...>> functionReferences;
+#if SYN_EVENT_INSTRUMENTATION
+        const char* debugName = nullptr;
+#endif
+
+    public:
+        size_t RefCount()
+        {
+            return functionReferences.size();
+        }
+
+        /** Name shown in the EventProfiler report, ignored unless SYN_EVENT_INSTRUMENTATION is enabled */
+        void SetDebugName(const char* Name)
+        {
+#if SYN_EVENT_INSTRUMENTATION
+            debugName = Name;
+#else
+            (void)Name;
+#endif
+        }
+
+        void SetCompaction(EventCompaction Compaction)
+        {
+            functionReferences.SetCompaction(Compaction);
+        }
+
+        EventHandle Register(void (*ref)(T...))
+        {
+            return functionReferences.Add(EventDelegate<T...>(ref));
+        }
+
+        /**
+         * Example Usage : Register([this](int Value) { OnValueChanged(Value); });
+         * Captures must fit in EventDelegate::InlineSize
+         **/
+        template <typename F>
+        EventHandle Register(F&& Callable)
+        {
+            return functionReferences.Add(EventDelegate<T...>(std::forward<F>(Callable)));
+        }
+
+        /**
+         * Example Usage : Register([this](int Value) { return TryConsume(Value); }, 100);
+         * Higher priorities run first. A callable returning bool can stop TriggerUntilHandled by returning true
+         **/
+        template <typename F>
+        EventHandle Register(F&& Callable, int32_t Priority)
+        {
+            return functionReferences.Add(EventDelegate<T...>(std::forward<F>(Callable)), Priority);
+        }
+
+        /**
+         * Example Usage : Register(obj, &Syn::Core::Obj::TestFunc);
+         * obj must outlive the registration. The method may take each parameter by value or by const reference
+         **/
+        template <typename C, typename R, typename... A>
+        EventHandle Register(C* Obj, R (C::*Func)(A...), int32_t Priority = 0)
+        {
+            static_assert(sizeof...(A) == sizeof...(T) && std::is_invocable_v<R (C::*)(A...), C*, EventParam<T>...>,
+                "Member listener parameters must be T or const T&");
+
+            return Register([Obj, Func](EventParam<T>... args)
+            {
+                return (Obj->*Func)(args...);
+            }, Priority);
+        }
+
+        bool Unregister(EventHandle Handle)
+        {
+            return functionReferences.Remove(Handle);
+        }
+
+        void Unregister(void (*ref)(T...))
+        {
+            functionReferences.Remove(functionReferences.FindHandle([&](EventDelegate<T...> const& delegate)
+            {
+                auto target = delegate.template Target<void(*)(T...)>();
+                return target != nullptr && *target == ref;
+            }));
+        }
+
+        /** Payloads reach every listener by const reference, listeners taking const T& see no copy at all */
+        void Trigger(EventParam<T>... args)
+        {
+            SYN_EVENT_PROFILE_TRIGGER(this, debugName, functionReferences.size());
+
+            functionReferences.Dispatch([&](EventDelegate<T...>& ref)
+            {
+                SYN_EVENT_PROFILE_LISTENER(this, debugName, functionReferences.SlotOf(ref));
+                ref(args...);
+            });
+        }
+
+        /**
+         * Same as Trigger, but the payload is moved into the last listener, which can take it over without a copy.
+         * Example Usage : Trigger.TriggerMoveLast(std::move(Message));
+         **/
+        void TriggerMoveLast(EventMoveParam<T>... args)
+        {
+            SYN_EVENT_PROFILE_TRIGGER(this, debugName, functionReferences.size());
+
+            functionReferences.Dispatch([&](EventDelegate<T...>& ref)
+            {
+                SYN_EVENT_PROFILE_LISTENER(this, debugName, functionReferences.SlotOf(ref));
+                ref(args...);
+            },
+            [&](EventDelegate<T...>& ref)
+            {
+                SYN_EVENT_PROFILE_LISTENER(this, debugName, functionReferences.SlotOf(ref));
+                ref.InvokeMove(std::forward<EventMoveParam<T>>(args)...);
+            });
+        }
+
+        /**
+         * Dispatches in priority order until a listener returns true.
+         * Returns the handle of the listener that handled the event, or an invalid handle
+         **/
+        EventHandle TriggerUntilHandled(EventParam<T>... args)
+        {
+            SYN_EVENT_PROFILE_TRIGGER(this, debugName, functionReferences.size());
+
+            return functionReferences.DispatchUntil([&](EventDelegate<T...>& ref)
+            {
+                SYN_EVENT_PROFILE_LISTENER(this, debugName, functionReferences.SlotOf(ref));
+                return ref(args...);
+            });
+        }
+
+        /**
+         * Delivers Count payload tuples listener by listener, each listener sees every payload before the next one runs.
+         * Payload must be a tuple whose elements can be passed as T...
+         **/
+        template <typename Payload>
+        void TriggerBatch(const Payload* Payloads, size_t Count)
+        {
+            if (Count == 0)
+            {
+                return;
+            }
+
+            SYN_EVENT_PROFILE_TRIGGER(this, debugName, functionReferences.size() * Count);
+
+            functionReferences.Dispatch([&](EventDelegate<T...>& ref)
+            {
+                SYN_EVENT_PROFILE_LISTENER(this, debugName, functionReferences.SlotOf(ref));
+                for (size_t index = 0; index < Count; ++index)
+                {
+                    std::apply(ref, Payloads[index]);
+                }
+            });
+        }
+
+        template <typename F>
+        Event<T...>& operator+(F&& Callable)
+        {
+            Register(std::forward<F>(Callable));
+
+            return *this;
+        }
+
+        Event<T...>& operator-(void (*ref)(T...))
+        {
+            Unregister(ref);
+
+            return *this;
+        }
+
+        Event<T...>& operator-(EventHandle Handle)
+        {
+            Unregister(Handle);
+
+            return *this;
+        }
+
+        template <typename F>
+        Event<T...>& operator+=(F&& Callable)
+        {
+            Register(std::forward<F>(Callable));
+
+            return *this;
+        }
+
+        Event<T...>& operator-=(void (*ref)(T...))
+        {
+            Unregister(ref);
+
+            return *this;
+        }
+
+        Event<T...>& operator-=(EventHandle Handle)
+        {
+            Unregister(Handle);
+
+            return *this;
+        }
+    };
+
+    /***
+     * Event that collects payloads and delivers them together on Flush, typically once per frame.
+     * Enqueue stores the arguments in a contiguous buffer, Flush hands them to each listener in turn (listener-major),
+     * so a burst of events runs every listener's code back to back instead of interleaving all of them per payload.
+     * Batch listeners receive the whole span in a single call.
+     * Payloads enqueued while a Flush is running are delivered by the next Flush.
+    **/
     template <typename... T>
-    class SYN_API Event
+    class SYN_API QueuedEvent
     {
+    public:
+        using Payload = std::tuple<std::decay_t<T>...>;
+
     private:
-        std::vector<void(*)(T...)> functionReferences;
+        Event<T...> listeners;
+        Event<const Payload*, size_t> batchListeners;
+
+        // Swapped on Flush, both keep their capacity so steady state enqueueing does not allocate
+        std::vector<Payload> pending;
+        std::vector<Payload> delivering;
+        bool isFlushing = false;
 
     public:
         size_t RefCount()
         {
-            return functionReferences.size();
+            return listeners.RefCount() + batchListeners.RefCount();
+        }
+
+        size_t PendingCount() const
+        {
+            return pending.size();
+        }
+
+        void Reserve(size_t Capacity)
+        {
+            pending.reserve(Capacity);
+            delivering.reserve(Capacity);
+        }
+
+        EventHandle Register(void (*ref)(T...))
+        {
+            return listeners.Register(ref);
+        }
+
+        template <typename F>
+        EventHandle Register(F&& Callable)
+        {
+            return listeners.Register(std::forward<F>(Callable));
         }
 
-        void Register(void (*ref)(T...))
+        bool Unregister(EventHandle Handle)
         {
-            functionReferences.push_back(ref);
+            return listeners.Unregister(Handle);
         }
 
         void Unregister(void (*ref)(T...))
         {
-            auto found = std::find(functionReferences.begin(), functionReferences.end(), ref);
-            if (found != functionReferences.end())
-            {
-                functionReferences.erase(found);
-            }
+            listeners.Unregister(ref);
+        }
+
+        /**
+         * Example Usage : RegisterBatch([](const QueuedEvent<int>::Payload* Payloads, size_t Count) { ... });
+         **/
+        template <typename F>
+        EventHandle RegisterBatch(F&& Callable)
+        {
+            return batchListeners.Register(std::forward<F>(Callable));
+        }
+
+        bool UnregisterBatch(EventHandle Handle)
+        {
+            return batchListeners.Unregister(Handle);
+        }
+
+        /** Copies or moves the arguments into the queue, depending on how they are passed */
+        template <typename... Args>
+        void Enqueue(Args&&... args)
+        {
+            static_assert(sizeof...(Args) == sizeof...(T), "Enqueue expects one argument per event parameter");
+            pending.emplace_back(std::forward<Args>(args)...);
         }
 
-        void Trigger(T... args)
+        /** Dispatches every payload enqueued so far */
+        void Flush()
         {
-            for (auto ref : functionReferences)
+            if (isFlushing || pending.empty())
             {
-                ref(args...);
+                return;
             }
+
+            isFlushing = true;
+            std::swap(pending, delivering);
+
+            listeners.TriggerBatch(delivering.data(), delivering.size());
+            batchListeners.Trigger(delivering.data(), delivering.size());
+
+            delivering.clear();
+            isFlushing = false;
+        }
+
+        /** Drops every payload enqueued so far without delivering it */
+        void Clear()
+        {
+            pending.clear();
         }
 
-        Event<T...>& operator+(void (*ref)(T...))
+        template <typename F>
+        QueuedEvent<T...>& operator+=(F&& Callable)
         {
-            Register(ref);
+            Register(std::forward<F>(Callable));
 
             return *this;
         }
 
-        Event<T...>& operator-(void (*ref)(T...))
+        QueuedEvent<T...>& operator-=(void (*ref)(T...))
         {
             Unregister(ref);
 
             return *this;
         }
 
-        Event<T...>& operator+=(void (*ref)(T...))
+        QueuedEvent<T...>& operator-=(EventHandle Handle)
         {
-            Register(ref);
+            Unregister(Handle);
 
             return *this;
         }
+    };
 
-        Event<T...>& operator-=(void (*ref)(T...))
+    /** ConcurrentEvent Triggers running on this thread, shared by every ConcurrentEvent type */
+    inline uint32_t& ConcurrentEventTriggerDepth()
+    {
+        thread_local uint32_t depth = 0;
+        return depth;
+    }
+
+    /***
+     * Multicast event that can be triggered from any thread.
+     * Trigger reads an immutable listener snapshot without taking a lock and never waits on a writer.
+     * Register/Unregister are serialized by a mutex: they copy the current snapshot, publish the modified copy,
+     * then wait for every Trigger that could still read the previous snapshot before deleting it.
+     * Once Unregister returns the removed listener is not running on any thread, so its owner can be destroyed.
+     * The exception is a write made from inside the listener of any ConcurrentEvent: waiting could wait for itself,
+     * or for a thread that is itself waiting, when two events change each other from listeners on different threads.
+     * Such a write returns at once, the removed listener may still run on other threads and the old snapshot
+     * is freed by the next write or Synchronize from outside a Trigger.
+    **/
+    template <typename... T>
+    class SYN_API ConcurrentEvent
+    {
+    private:
+        struct Listener
+        {
+            EventDelegate<T...> delegate;
+            EventHandle handle;
+        };
+
+        struct Snapshot
+        {
+            std::vector<Listener> listeners;
+        };
+
+        std::atomic<Snapshot*> current{nullptr};
+
+        // Readers count themselves under the parity of the epoch they entered in, a writer flips the epoch
+        // and waits for the old parity to drain, after which no reader can hold a snapshot replaced before the flip
+        std::atomic<uint32_t> epoch{0};
+        std::atomic<uint32_t> readers[2] = {{0}, {0}};
+
+        std::mutex writeMutex;
+        std::vector<Snapshot*> retired;
+        EventHandle nextHandle{0, 0};
+
+        // Serializes epoch flips so every flip is drained before the next one, never held while taking writeMutex
+        // for longer than swapping out the retired list, so listeners writing to the event cannot deadlock a waiter
+        std::mutex reclaimMutex;
+
+        EventHandle NextHandle()
+        {
+            EventHandle handle = nextHandle;
+            if (++nextHandle.index == EventHandle::InvalidIndex)
+            {
+                nextHandle.index = 0;
+                ++nextHandle.generation;
+            }
+            return handle;
+        }
+
+        Snapshot* CopySnapshot() const
+        {
+            const Snapshot* snapshot = current.load(std::memory_order_acquire);
+            return snapshot != nullptr ? new Snapshot(*snapshot) : new Snapshot();
+        }
+
+        // Must be called with writeMutex held
+        void Publish(Snapshot* Next)
+        {
+            Snapshot* previous = current.exchange(Next, std::memory_order_seq_cst);
+            if (previous != nullptr)
+            {
+                retired.push_back(previous);
+            }
+        }
+
+        // Must be called without writeMutex held, does nothing from a Trigger of any ConcurrentEvent on this thread
+        void ReclaimRetired()
+        {
+            if (ConcurrentEventTriggerDepth() != 0)
+            {
+                return;
+            }
+
+            std::lock_guard<std::mutex> reclaimLock(reclaimMutex);
+
+            // Only snapshots replaced before the flip are safe once its readers drained
+            std::vector<Snapshot*> reclaimed;
+            uint32_t previousEpoch;
+            {
+                std::lock_guard<std::mutex> lock(writeMutex);
+                reclaimed.swap(retired);
+                previousEpoch = epoch.fetch_add(1, std::memory_order_seq_cst);
+            }
+
+            while (readers[previousEpoch & 1].load(std::memory_order_seq_cst) != 0)
+            {
+                std::this_thread::yield();
+            }
+
+            for (Snapshot* snapshot : reclaimed)
+            {
+                delete snapshot;
+            }
+        }
+
+        template <typename Predicate>
+        bool RemoveFirst(Predicate&& Pred)
+        {
+            {
+                std::lock_guard<std::mutex> lock(writeMutex);
+
+                const Snapshot* snapshot = current.load(std::memory_order_acquire);
+                if (snapshot == nullptr)
+                {
+                    return false;
+                }
+
+                auto found = std::find_if(snapshot->listeners.begin(), snapshot->listeners.end(), Pred);
+                if (found == snapshot->listeners.end())
+                {
+                    return false;
+                }
+
+                Snapshot* next = CopySnapshot();
+                next->listeners.erase(next->listeners.begin() + (found - snapshot->listeners.begin()));
+                Publish(next);
+            }
+
+            ReclaimRetired();
+            return true;
+        }
+
+    public:
+        ConcurrentEvent() = default;
+        ConcurrentEvent(const ConcurrentEvent&) = delete;
+        ConcurrentEvent& operator=(const ConcurrentEvent&) = delete;
+
+        ~ConcurrentEvent()
+        {
+            delete current.load(std::memory_order_acquire);
+            for (Snapshot* snapshot : retired)
+            {
+                delete snapshot;
+            }
+        }
+
+        size_t RefCount() const
+        {
+            const Snapshot* snapshot = current.load(std::memory_order_acquire);
+            return snapshot != nullptr ? snapshot->listeners.size() : 0;
+        }
+
+        /**
+         * Waits for every Trigger in flight and frees snapshots left by writes made from inside a listener.
+         * Does nothing when called from a listener of any ConcurrentEvent.
+         **/
+        void Synchronize()
+        {
+            ReclaimRetired();
+        }
+
+        EventHandle Register(void (*ref)(T...))
+        {
+            return Register(EventDelegate<T...>(ref));
+        }
+
+        /**
+         * Example Usage : Register([this](int Value) { OnValueChanged(Value); });
+         * The callable may be invoked from several threads at once
+         **/
+        template <typename F>
+        EventHandle Register(F&& Callable)
+        {
+            EventDelegate<T...> delegate(std::forward<F>(Callable));
+            EventHandle handle;
+
+            {
+                std::lock_guard<std::mutex> lock(writeMutex);
+
+                Snapshot* next = CopySnapshot();
+                handle = NextHandle();
+                next->listeners.push_back(Listener{std::move(delegate), handle});
+                Publish(next);
+            }
+
+            ReclaimRetired();
+            return handle;
+        }
+
+        bool Unregister(EventHandle Handle)
+        {
+            return RemoveFirst([&](const Listener& listener)
+            {
+                return listener.handle == Handle;
+            });
+        }
+
+        void Unregister(void (*ref)(T...))
+        {
+            RemoveFirst([&](const Listener& listener)
+            {
+                auto target = listener.delegate.template Target<void(*)(T...)>();
+                return target != nullptr && *target == ref;
+            });
+        }
+
+        void Trigger(EventParam<T>... args)
+        {
+            // Entering under an epoch a writer flipped meanwhile would not be waited for, retry under the new one
+            uint32_t readerEpoch = epoch.load(std::memory_order_seq_cst);
+            for (;;)
+            {
+                readers[readerEpoch & 1].fetch_add(1, std::memory_order_seq_cst);
+                const uint32_t currentEpoch = epoch.load(std::memory_order_seq_cst);
+                if (currentEpoch == readerEpoch)
+                {
+                    break;
+                }
+                readers[readerEpoch & 1].fetch_sub(1, std::memory_order_seq_cst);
+                readerEpoch = currentEpoch;
+            }
+
+            ++ConcurrentEventTriggerDepth();
+
+            Snapshot* snapshot = current.load(std::memory_order_seq_cst);
+            if (snapshot != nullptr)
+            {
+                for (Listener& listener : snapshot->listeners)
+                {
+                    listener.delegate(args...);
+                }
+            }
+
+            --ConcurrentEventTriggerDepth();
+            readers[readerEpoch & 1].fetch_sub(1, std::memory_order_release);
+        }
+
+        template <typename F>
+        ConcurrentEvent<T...>& operator+=(F&& Callable)
+        {
+            Register(std::forward<F>(Callable));
+
+            return *this;
+        }
+
+        ConcurrentEvent<T...>& operator-=(void (*ref)(T...))
         {
             Unregister(ref);
 
             return *this;
         }
+
+        ConcurrentEvent<T...>& operator-=(EventHandle Handle)
+        {
+            Unregister(Handle);
+
+            return *this;
+        }
     };
 
     /***
@@ -78,21 +1342,81 @@ namespace Syn
     template <typename... T>
     class SYN_API LinkedEvent
     {
-        template <typename... T>
+    public:
         class SYN_API LinkedEventClass
         {
         public:
+            using Thunk = void (*)(const LinkedEventClass&, EventParam<T>...);
+
             Syn::Engine::PTR<Syn::Core::Object> objRef;
-            void (Syn::Core::Object::*funcRef)(T...);
+            void (Syn::Core::Object::*funcRef)(T...) = nullptr;
+            Thunk thunk = &InvokeMember;
+
+            /** Legacy path, calls through the base class pointer-to-member stored in funcRef */
+            static void InvokeMember(const LinkedEventClass& Self, EventParam<T>... args)
+            {
+                (Self.objRef.Get().*Self.funcRef)(args...);
+            }
 
-            void operator ()(T... args)
+            /**
+             * Bind path, Method is a compile time constant so the call is resolved statically on the real class.
+             * Bind only accepts a PTR to C, which makes the downcast safe
+             **/
+            template <typename C, auto Method>
+            static void InvokeBound(const LinkedEventClass& Self, EventParam<T>... args)
             {
-                return (this->objRef.Get().*this->funcRef)(args...);
+                (static_cast<C&>(Self.objRef.Get()).*Method)(args...);
             }
+
+            void operator ()(EventParam<T>... args)
+            {
+                return this->thunk(*this, args...);
+            }
+        };
+
+        /** Listener counts observed by the last Trigger, dead entries are swept by that same Trigger */
+        struct SYN_API LinkedEventStats
+        {
+            size_t liveListeners = 0;
+            size_t deadListeners = 0;
+            size_t totalSweptListeners = 0;
         };
 
     private:
-        std::vector<LinkedEventClass<T...>> functionReferences;
+        /** Any other signature ends here, Class falls back to Object so the assert is the only error reported */
+        template <typename M>
+        struct MemberFunction
+        {
+            static_assert(sizeof(M) == 0, "Bind<&Class::Method> needs a non-static member function returning void");
+            using Class = Syn::Core::Object;
+            static constexpr bool bSupported = false;
+            static constexpr bool bAcceptsParams = true;
+        };
+
+        /** Parameters may be T or const T&, Bind checks the method can take what Trigger passes */
+        template <typename C, typename... A>
+        struct MemberFunction<void (C::*)(A...)>
+        {
+            using Class = C;
+            static constexpr bool bSupported = true;
+            static constexpr bool bAcceptsParams = sizeof...(A) == sizeof...(T)
+                && std::is_invocable_v<void (C::*)(A...), C&, EventParam<T>...>;
+        };
+
+        template <typename C, typename... A>
+        struct MemberFunction<void (C::*)(A...) const>
+        {
+            using Class = C;
+            static constexpr bool bSupported = true;
+            static constexpr bool bAcceptsParams = sizeof...(A) == sizeof...(T)
+                && std::is_invocable_v<void (C::*)(A...) const, C&, EventParam<T>...>;
+        };
+
+        EventListenerStore<LinkedEventClass> functionReferences;
+        LinkedEventStats stats;
+#if SYN_EVENT_INSTRUMENTATION
+        const char* debugName = nullptr;
+#endif
 
     public:
         inline size_t RefCount()
@@ -100,52 +1424,140 @@ namespace Syn
             return functionReferences.size();
         }
 
+        /** Name shown in the EventProfiler report, ignored unless SYN_EVENT_INSTRUMENTATION is enabled */
+        void SetDebugName(const char* Name)
+        {
+#if SYN_EVENT_INSTRUMENTATION
+            debugName = Name;
+#else
+            (void)Name;
+#endif
+        }
+
+        inline const LinkedEventStats& GetStats() const
+        {
+            return stats;
+        }
+
+        /** SwapAndPop by default, Stable keeps listeners in registration order while sweeping dead ones */
+        void SetCompaction(EventCompaction Compaction)
+        {
+            functionReferences.SetCompaction(Compaction);
+        }
+
         /**
          * Example Usage : Register(obj, DYNAMIC_LINKED_EVENT(&Syn::Core::Obj::TestFunc));
          * obj must be PTR
          **/
-        void Register(Syn::Engine::PTR<Syn::Core::Object> Obj, void (Syn::Core::Object::*Func)(T...))
+        EventHandle Register(Syn::Engine::PTR<Syn::Core::Object> Obj, void (Syn::Core::Object::*Func)(T...))
         {
-            LinkedEventClass<T...> LinkedEventClassObj;
+            LinkedEventClass LinkedEventClassObj;
             LinkedEventClassObj.objRef = Obj;
             LinkedEventClassObj.funcRef = Func;
 
-            functionReferences.push_back(LinkedEventClassObj);
+            return functionReferences.Add(std::move(LinkedEventClassObj));
         }
 
-        void Unregister(Syn::Engine::PTR<Syn::Core::Object> Obj, void (Syn::Core::Object::*Func)(T...))
+        /** Class of a bound method, Bind and Unbind take a PTR to it so the object type is checked by the compiler */
+        template <auto Method>
+        using BoundClass = typename MemberFunction<decltype(Method)>::Class;
+
+        /** Null for signatures MemberFunction rejects, so its assert stays the only error */
+        template <auto Method>
+        static constexpr typename LinkedEventClass::Thunk BoundThunk()
         {
-            auto found = std::find_if(functionReferences.begin(), functionReferences.end(),
-                                      [&](LinkedEventClass<T...> const& lec)
-                                      {
-                                          return lec.objRef == Obj && Func == lec.funcRef;
-                                      });
-            if (found != functionReferences.end())
+            if constexpr (MemberFunction<decltype(Method)>::bSupported)
+            {
+                return &LinkedEventClass::template InvokeBound<BoundClass<Method>, Method>;
+            }
+            else
             {
-                functionReferences.erase(found);
+                return nullptr;
             }
         }
 
-        void Trigger(T... args)
+        /**
+         * Example Usage : Bind<&Syn::Core::Obj::TestFunc>(obj);
+         * obj must be PTR to the method's class or a class derived from it, no cast macro is needed.
+         * Method must return void and may be const
+         **/
+        template <auto Method>
+        EventHandle Bind(Syn::Engine::PTR<BoundClass<Method>> Obj)
+        {
+            using Class = BoundClass<Method>;
+            static_assert(std::is_base_of_v<Syn::Core::Object, Class>, "Bound method must belong to a Syn::Core::Object");
+            static_assert(MemberFunction<decltype(Method)>::bAcceptsParams, "Bound method parameters must be T or const T&");
+
+            LinkedEventClass LinkedEventClassObj;
+            LinkedEventClassObj.objRef = Syn::Engine::PTR<Syn::Core::Object>(Obj);
+            LinkedEventClassObj.thunk = BoundThunk<Method>();
+
+            return functionReferences.Add(std::move(LinkedEventClassObj));
+        }
+
+        template <auto Method>
+        void Unbind(Syn::Engine::PTR<BoundClass<Method>> Obj)
+        {
+            const typename LinkedEventClass::Thunk Thunk = BoundThunk<Method>();
+            const Syn::Engine::PTR<Syn::Core::Object> ObjRef(Obj);
+
+            functionReferences.Remove(functionReferences.FindHandle([&](LinkedEventClass const& lec)
+            {
+                return lec.objRef == ObjRef && lec.thunk == Thunk;
+            }));
+        }
+
+        bool Unregister(EventHandle Handle)
         {
-            for (auto& Ref : functionReferences)
+            return functionReferences.Remove(Handle);
+        }
+
+        void Unregister(Syn::Engine::PTR<Syn::Core::Object> Obj, void (Syn::Core::Object::*Func)(T...))
+        {
+            functionReferences.Remove(functionReferences.FindHandle([&](LinkedEventClass const& lec)
+            {
+                return lec.objRef == Obj && lec.thunk == &LinkedEventClass::InvokeMember && Func == lec.funcRef;
+            }));
+        }
+
+        void Trigger(EventParam<T>... args)
+        {
+            SYN_EVENT_PROFILE_TRIGGER(this, debugName, functionReferences.size());
+
+            size_t live = 0;
+            const size_t dead = functionReferences.DispatchAndSweep([&](LinkedEventClass& Ref)
             {
-                if (Ref.objRef.IsValid())
+                if (!Ref.objRef.IsValid())
                 {
-                    Ref(args...);
+                    return false;
                 }
-            }
+
+                ++live;
+                SYN_EVENT_PROFILE_LISTENER(this, debugName, functionReferences.SlotOf(Ref));
+                Ref(args...);
+                return true;
+            });
+
+            stats.liveListeners = live;
+            stats.deadListeners = dead;
+            stats.totalSweptListeners += dead;
+        }
+
+        LinkedEvent<T...>& operator+(LinkedEventClass ClassObj)
+        {
+            functionReferences.Add(std::move(ClassObj));
+            return *this;
         }
 
-        LinkedEvent<T...>& operator+(LinkedEventClass<T...> ClassObj)
+        LinkedEvent<T...>& operator+=(LinkedEventClass ClassObj)
         {
-            Register(ClassObj->objRef, ClassObj->funcRef);
+            functionReferences.Add(std::move(ClassObj));
             return *this;
         }
 
-        LinkedEvent<T...>& operator+=(LinkedEventClass<T...> ClassObj)
+        LinkedEvent<T...>& operator-=(EventHandle Handle)
         {
-            Register(ClassObj->objRef, ClassObj->funcRef);
+            Unregister(Handle);
             return *this;
         }
     };
@@ -159,6 +1571,7 @@ namespace Syn
 #define DYNAMIC_LINKED_EVENT_FOUR_PARAM(Param1,Param2,Param3,Param4) LinkedEvent<Param1,Param2,Param3,Param4>
 #define DYNAMIC_LINKED_EVENT_FIVE_PARAM(Param1,Param2,Param3,Param4,Param5) LinkedEvent<Param1,Param2,Param3,Param4,Param5>
 
+    //Legacy, only needed by Register(Obj, Func). Prefer Bind<&Class::Method>(Obj) which keeps the real class type
 #define WRAP_LINKED_EVENT_FUNCTION(T) static_cast<void(Syn::Core::Object::*)()>(T)
 #define WRAP_LINKED_EVENT_FUNCTION_ONE_PARAM(T, Param1) static_cast<void(Syn::Core::Object::*)(Param1)>(T)
 #define WRAP_LINKED_EVENT_FUNCTION_TWO_PARAM(T, Param1, Param2) static_cast<void(Syn::Core::Object::*)(Param1,Param2)>(T)
@@ -0,0 +1,365 @@
+#pragma once
+
+#include "../../Runtime/Core/Core.h"
+
+/***
+ * Opt-in instrumentation for Event and LinkedEvent.
+ * Define SYN_EVENT_INSTRUMENTATION=1 to record trigger counts, listener counts and per-listener latency.
+ * When it is 0 (default) the profiling macros expand to nothing and no profiling state is added to events.
+**/
+#ifndef SYN_EVENT_INSTRUMENTATION
+#define SYN_EVENT_INSTRUMENTATION 0
+#endif
+
+#if SYN_EVENT_INSTRUMENTATION
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/** Records per thread, samples for new events/listeners are dropped once a thread's table is full */
+#ifndef SYN_EVENT_PROFILER_CAPACITY
+#define SYN_EVENT_PROFILER_CAPACITY 1024
+#endif
+
+namespace Syn
+{
+    /***
+     * Collects event timings into per-thread tables.
+     * Only the owning thread writes to its table, so recording is lock-free, the mutex is taken once per thread
+     * on first use and by BuildReport/Reset.
+    **/
+    class SYN_API EventProfiler
+    {
+    public:
+        static constexpr uint32_t EventRecord = 0xFFFFFFFFu;
+        // Bucket i holds samples below 2^i nanoseconds, the last one everything above
+        static constexpr size_t HistogramBuckets = 32;
+
+    private:
+        struct Record
+        {
+            std::atomic<const void*> event{nullptr};
+            std::atomic<uint32_t> listener{EventRecord};
+            std::atomic<const char*> name{nullptr};
+            std::atomic<uint64_t> count{0};
+            std::atomic<uint64_t> listenerCalls{0};
+            std::atomic<uint64_t> totalNanoseconds{0};
+            std::atomic<uint64_t> maxNanoseconds{0};
+            std::atomic<uint64_t> histogram[HistogramBuckets] = {};
+        };
+
+        struct ThreadTable
+        {
+            Record records[SYN_EVENT_PROFILER_CAPACITY];
+            std::atomic<uint64_t> droppedSamples{0};
+        };
+
+        struct Entry
+        {
+            const void* event = nullptr;
+            uint32_t listener = EventRecord;
+            const char* name = nullptr;
+            uint64_t count = 0;
+            uint64_t listenerCalls = 0;
+            uint64_t totalNanoseconds = 0;
+            uint64_t maxNanoseconds = 0;
+            uint64_t histogram[HistogramBuckets] = {};
+        };
+
+        std::mutex tablesMutex;
+        std::vector<ThreadTable*> tables;
+
+        // Owner thread only, so plain load/store is enough and no locked instruction is emitted
+        static void Increase(std::atomic<uint64_t>& Counter, uint64_t Amount)
+        {
+            Counter.store(Counter.load(std::memory_order_relaxed) + Amount, std::memory_order_relaxed);
+        }
+
+        static size_t HistogramBucket(uint64_t Nanoseconds)
+        {
+            size_t bucket = 0;
+            while (bucket + 1 < HistogramBuckets && (uint64_t(1) << bucket) <= Nanoseconds)
+            {
+                ++bucket;
+            }
+            return bucket;
+        }
+
+        ThreadTable& LocalTable()
+        {
+            thread_local ThreadTable* table = nullptr;
+            if (table == nullptr)
+            {
+                table = new ThreadTable();
+                std::lock_guard<std::mutex> lock(tablesMutex);
+                tables.push_back(table);
+            }
+            return *table;
+        }
+
+        Record* FindOrAdd(const void* Event, uint32_t Listener, const char* Name)
+        {
+            ThreadTable& table = LocalTable();
+
+            const size_t hash = (reinterpret_cast<uintptr_t>(Event) >> 3) * 0x9E3779B97F4A7C15ull ^ Listener;
+            for (size_t probe = 0; probe < SYN_EVENT_PROFILER_CAPACITY; ++probe)
+            {
+                Record& record = table.records[(hash + probe) % SYN_EVENT_PROFILER_CAPACITY];
+                const void* recordEvent = record.event.load(std::memory_order_relaxed);
+                if (recordEvent == Event && record.listener.load(std::memory_order_relaxed) == Listener)
+                {
+                    return &record;
+                }
+                if (recordEvent == nullptr)
+                {
+                    record.listener.store(Listener, std::memory_order_relaxed);
+                    record.name.store(Name, std::memory_order_relaxed);
+                    record.event.store(Event, std::memory_order_release);
+                    return &record;
+                }
+            }
+
+            Increase(table.droppedSamples, 1);
+            return nullptr;
+        }
+
+        static void Accumulate(Entry& Target, const Record& Source)
+        {
+            Target.count += Source.count.load(std::memory_order_relaxed);
+            Target.listenerCalls += Source.listenerCalls.load(std::memory_order_relaxed);
+            Target.totalNanoseconds += Source.totalNanoseconds.load(std::memory_order_relaxed);
+            Target.maxNanoseconds = std::max(Target.maxNanoseconds, Source.maxNanoseconds.load(std::memory_order_relaxed));
+            for (size_t bucket = 0; bucket < HistogramBuckets; ++bucket)
+            {
+                Target.histogram[bucket] += Source.histogram[bucket].load(std::memory_order_relaxed);
+            }
+        }
+
+        static uint64_t Percentile(const Entry& Source, double Fraction)
+        {
+            const uint64_t target = static_cast<uint64_t>(static_cast<double>(Source.count) * Fraction);
+            uint64_t seen = 0;
+            for (size_t bucket = 0; bucket < HistogramBuckets; ++bucket)
+            {
+                seen += Source.histogram[bucket];
+                if (seen > target)
+                {
+                    return uint64_t(1) << bucket;
+                }
+            }
+            return Source.maxNanoseconds;
+        }
+
+        static void AppendEntry(std::string& Report, const Entry& Source)
+        {
+            char line[256];
+            const uint64_t average = Source.count > 0 ? Source.totalNanoseconds / Source.count : 0;
+            if (Source.listener == EventRecord)
+            {
+                std::snprintf(line, sizeof(line),
+                              "  %-32s %p triggers %10llu avg listeners %6.1f total %12llu ns avg %8llu ns p99 <%8llu ns max %8llu ns\n",
+                              Source.name != nullptr ? Source.name : "<unnamed>", Source.event,
+                              static_cast<unsigned long long>(Source.count),
+                              Source.count > 0 ? static_cast<double>(Source.listenerCalls) / static_cast<double>(Source.count) : 0.0,
+                              static_cast<unsigned long long>(Source.totalNanoseconds),
+                              static_cast<unsigned long long>(average),
+                              static_cast<unsigned long long>(Percentile(Source, 0.99)),
+                              static_cast<unsigned long long>(Source.maxNanoseconds));
+            }
+            else
+            {
+                std::snprintf(line, sizeof(line),
+                              "  %-32s %p listener %5u calls %10llu total %12llu ns avg %8llu ns p50 <%8llu ns p99 <%8llu ns max %8llu ns\n",
+                              Source.name != nullptr ? Source.name : "<unnamed>", Source.event, Source.listener,
+                              static_cast<unsigned long long>(Source.count),
+                              static_cast<unsigned long long>(Source.totalNanoseconds),
+                              static_cast<unsigned long long>(average),
+                              static_cast<unsigned long long>(Percentile(Source, 0.5)),
+                              static_cast<unsigned long long>(Percentile(Source, 0.99)),
+                              static_cast<unsigned long long>(Source.maxNanoseconds));
+            }
+            Report += line;
+        }
+
+    public:
+        static EventProfiler& Get()
+        {
+            static EventProfiler profiler;
+            return profiler;
+        }
+
+        static uint64_t Now()
+        {
+            return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now().time_since_epoch()).count());
+        }
+
+        void RecordTrigger(const void* Event, const char* Name, size_t ListenerCount, uint64_t Nanoseconds)
+        {
+            if (Record* record = FindOrAdd(Event, EventRecord, Name))
+            {
+                Increase(record->count, 1);
+                Increase(record->listenerCalls, ListenerCount);
+                Increase(record->totalNanoseconds, Nanoseconds);
+                Increase(record->histogram[HistogramBucket(Nanoseconds)], 1);
+                if (Nanoseconds > record->maxNanoseconds.load(std::memory_order_relaxed))
+                {
+                    record->maxNanoseconds.store(Nanoseconds, std::memory_order_relaxed);
+                }
+            }
+        }
+
+        void RecordListener(const void* Event, const char* Name, uint32_t Listener, uint64_t Nanoseconds)
+        {
+            if (Record* record = FindOrAdd(Event, Listener, Name))
+            {
+                Increase(record->count, 1);
+                Increase(record->totalNanoseconds, Nanoseconds);
+                Increase(record->histogram[HistogramBucket(Nanoseconds)], 1);
+                if (Nanoseconds > record->maxNanoseconds.load(std::memory_order_relaxed))
+                {
+                    record->maxNanoseconds.store(Nanoseconds, std::memory_order_relaxed);
+                }
+            }
+        }
+
+        /** Merges every thread's table and lists the most expensive events and listeners by total time */
+        std::string BuildReport(size_t MaxEntries = 20)
+        {
+            std::vector<Entry> events;
+            std::vector<Entry> listeners;
+            uint64_t dropped = 0;
+
+            {
+                std::lock_guard<std::mutex> lock(tablesMutex);
+                for (ThreadTable* table : tables)
+                {
+                    dropped += table->droppedSamples.load(std::memory_order_relaxed);
+                    for (const Record& record : table->records)
+                    {
+                        const void* event = record.event.load(std::memory_order_acquire);
+                        if (event == nullptr)
+                        {
+                            continue;
+                        }
+
+                        const uint32_t listener = record.listener.load(std::memory_order_relaxed);
+                        std::vector<Entry>& entries = listener == EventRecord ? events : listeners;
+                        auto found = std::find_if(entries.begin(), entries.end(), [&](const Entry& entry)
+                        {
+                            return entry.event == event && entry.listener == listener;
+                        });
+                        if (found == entries.end())
+                        {
+                            entries.emplace_back();
+                            found = entries.end() - 1;
+                            found->event = event;
+                            found->listener = listener;
+                            found->name = record.name.load(std::memory_order_relaxed);
+                        }
+                        Accumulate(*found, record);
+                    }
+                }
+            }
+
+            auto byTotalTime = [](const Entry& A, const Entry& B)
+            {
+                return A.totalNanoseconds > B.totalNanoseconds;
+            };
+            std::sort(events.begin(), events.end(), byTotalTime);
+            std::sort(listeners.begin(), listeners.end(), byTotalTime);
+
+            std::string report = "Events by total trigger time:\n";
+            for (size_t index = 0; index < events.size() && index < MaxEntries; ++index)
+            {
+                AppendEntry(report, events[index]);
+            }
+            report += "Listeners by total time:\n";
+            for (size_t index = 0; index < listeners.size() && index < MaxEntries; ++index)
+            {
+                AppendEntry(report, listeners[index]);
+            }
+            if (dropped > 0)
+            {
+                report += "Dropped samples (table full): " + std::to_string(dropped) + "\n";
+            }
+            return report;
+        }
+
+        /** Clears every table, only call while no event is being triggered */
+        void Reset()
+        {
+            std::lock_guard<std::mutex> lock(tablesMutex);
+            for (ThreadTable* table : tables)
+            {
+                for (Record& record : table->records)
+                {
+                    record.event.store(nullptr, std::memory_order_relaxed);
+                    record.listener.store(EventRecord, std::memory_order_relaxed);
+                    record.name.store(nullptr, std::memory_order_relaxed);
+                    record.count.store(0, std::memory_order_relaxed);
+                    record.listenerCalls.store(0, std::memory_order_relaxed);
+                    record.totalNanoseconds.store(0, std::memory_order_relaxed);
+                    record.maxNanoseconds.store(0, std::memory_order_relaxed);
+                    for (auto& bucket : record.histogram)
+                    {
+                        bucket.store(0, std::memory_order_relaxed);
+                    }
+                }
+                table->droppedSamples.store(0, std::memory_order_relaxed);
+            }
+        }
+    };
+
+    struct SYN_API EventTriggerScope
+    {
+        const void* event;
+        const char* name;
+        size_t listenerCount;
+        uint64_t start;
+
+        EventTriggerScope(const void* InEvent, const char* InName, size_t InListenerCount)
+            : event(InEvent), name(InName), listenerCount(InListenerCount), start(EventProfiler::Now())
+        {
+        }
+
+        ~EventTriggerScope()
+        {
+            EventProfiler::Get().RecordTrigger(event, name, listenerCount, EventProfiler::Now() - start);
+        }
+    };
+
+    struct SYN_API EventListenerScope
+    {
+        const void* event;
+        const char* name;
+        uint32_t listener;
+        uint64_t start;
+
+        EventListenerScope(const void* InEvent, const char* InName, uint32_t InListener)
+            : event(InEvent), name(InName), listener(InListener), start(EventProfiler::Now())
+        {
+        }
+
+        ~EventListenerScope()
+        {
+            EventProfiler::Get().RecordListener(event, name, listener, EventProfiler::Now() - start);
+        }
+    };
+}
+
+#define SYN_EVENT_PROFILE_TRIGGER(Event, Name, ListenerCount) Syn::EventTriggerScope SynEventTriggerScope(Event, Name, ListenerCount)
+#define SYN_EVENT_PROFILE_LISTENER(Event, Name, Listener) Syn::EventListenerScope SynEventListenerScope(Event, Name, Listener)
+
+#else
+
+#define SYN_EVENT_PROFILE_TRIGGER(Event, Name, ListenerCount)
+#define SYN_EVENT_PROFILE_LISTENER(Event, Name, Listener)
+
+#endif
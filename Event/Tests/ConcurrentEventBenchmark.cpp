@@ -0,0 +1,107 @@
+#include "../Event.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+/***
+ * Compares ConcurrentEvent::Trigger with a mutex-guarded vector of listeners, run as a standalone program.
+ * Usage : ConcurrentEventBenchmark [ThreadCount] [TriggersPerThread] [ListenerCount]
+ * Thread counts are doubled from 1 up to ThreadCount, the result is nanoseconds per Trigger seen by one thread.
+**/
+namespace
+{
+    /** Baseline, the lock is held for the whole dispatch like a naive thread-safe multicast would */
+    class MutexEvent
+    {
+    private:
+        std::mutex mutex;
+        std::vector<std::function<void(int)>> listeners;
+
+    public:
+        void Register(std::function<void(int)> Listener)
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            listeners.push_back(std::move(Listener));
+        }
+
+        void Trigger(int Value)
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            for (const std::function<void(int)>& listener : listeners)
+            {
+                listener(Value);
+            }
+        }
+    };
+
+    template <typename EventType>
+    double MeasureNanosecondsPerTrigger(EventType& Event, int ThreadCount, int TriggersPerThread)
+    {
+        std::atomic<int> ready{0};
+        std::atomic<bool> go{false};
+        std::vector<std::thread> threads;
+        for (int i = 0; i < ThreadCount; ++i)
+        {
+            threads.emplace_back([&]()
+            {
+                ++ready;
+                while (!go.load())
+                {
+                    std::this_thread::yield();
+                }
+                for (int j = 0; j < TriggersPerThread; ++j)
+                {
+                    Event.Trigger(j);
+                }
+            });
+        }
+
+        while (ready.load() != ThreadCount)
+        {
+            std::this_thread::yield();
+        }
+
+        const auto start = std::chrono::steady_clock::now();
+        go = true;
+        for (std::thread& thread : threads)
+        {
+            thread.join();
+        }
+        const auto elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+
+        return elapsed / TriggersPerThread;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    const int threadCount = argc > 1 ? std::atoi(argv[1]) : std::max(1, int(std::thread::hardware_concurrency()));
+    const int triggersPerThread = argc > 2 ? std::atoi(argv[2]) : 200000;
+    const int listenerCount = argc > 3 ? std::atoi(argv[3]) : 4;
+
+    // One sink per listener, both events write the same sinks so the listener work is identical
+    std::vector<std::atomic<int64_t>> sinks(listenerCount);
+
+    Syn::ConcurrentEvent<int> concurrentEvent;
+    MutexEvent mutexEvent;
+    for (int i = 0; i < listenerCount; ++i)
+    {
+        std::atomic<int64_t>* sink = &sinks[i];
+        concurrentEvent.Register([sink](int Value) { sink->fetch_add(Value, std::memory_order_relaxed); });
+        mutexEvent.Register([sink](int Value) { sink->fetch_add(Value, std::memory_order_relaxed); });
+    }
+
+    std::printf("%d listeners, %d triggers per thread\n", listenerCount, triggersPerThread);
+    std::printf("%8s %20s %20s\n", "Threads", "ConcurrentEvent ns", "Mutex vector ns");
+    for (int threads = 1; threads <= threadCount; threads *= 2)
+    {
+        const double concurrentTime = MeasureNanosecondsPerTrigger(concurrentEvent, threads, triggersPerThread);
+        const double mutexTime = MeasureNanosecondsPerTrigger(mutexEvent, threads, triggersPerThread);
+        std::printf("%8d %20.1f %20.1f\n", threads, concurrentTime, mutexTime);
+    }
+
+    return 0;
+}
@@ -0,0 +1,146 @@
+#include "../Event.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <thread>
+
+/***
+ * Stress test for ConcurrentEvent, run as a standalone program, returns non zero on failure.
+ * Usage : ConcurrentEventStressTest [ProducerCount] [TriggersPerProducer]
+ * Run it under AddressSanitizer or ThreadSanitizer, a listener running after Unregister returned
+ * touches a freed counter and is reported there.
+**/
+namespace
+{
+    struct Counter
+    {
+        std::atomic<int64_t> value{0};
+    };
+
+    int failures = 0;
+
+    void Check(bool Condition, const char* Message)
+    {
+        if (!Condition)
+        {
+            std::printf("FAILED : %s\n", Message);
+            ++failures;
+        }
+    }
+
+    /** N producers trigger while a writer keeps adding and removing listeners, the permanent listener sees every trigger */
+    void ProducersWithChurningListeners(int ProducerCount, int TriggersPerProducer)
+    {
+        Syn::ConcurrentEvent<int> event;
+        Counter permanent;
+        event.Register([&permanent](int Value) { permanent.value += Value; });
+
+        std::atomic<int> runningProducers{ProducerCount};
+        std::vector<std::thread> producers;
+        for (int i = 0; i < ProducerCount; ++i)
+        {
+            producers.emplace_back([&]()
+            {
+                for (int j = 0; j < TriggersPerProducer; ++j)
+                {
+                    event.Trigger(1);
+                }
+                --runningProducers;
+            });
+        }
+
+        int churned = 0;
+        while (runningProducers.load() > 0)
+        {
+            // Freed right after Unregister, the listener must not run anymore on any producer
+            auto counter = std::make_unique<Counter>();
+            Counter* target = counter.get();
+            const Syn::EventHandle handle = event.Register([target](int Value) { target->value += Value; });
+            std::this_thread::yield();
+            Check(event.Unregister(handle), "Unregister of a registered handle returned false");
+            counter.reset();
+            ++churned;
+        }
+
+        for (std::thread& producer : producers)
+        {
+            producer.join();
+        }
+
+        Check(permanent.value.load() == int64_t(ProducerCount) * TriggersPerProducer, "Permanent listener missed triggers");
+        Check(event.RefCount() == 1, "Churned listeners are still registered");
+        std::printf("Producers with churning listeners : %d producers, %d triggers each, %d listeners churned\n",
+                    ProducerCount, TriggersPerProducer, churned);
+    }
+
+    /** Listeners of two events write to the other event from different threads, neither write may wait on the other */
+    void CrossEventWritesFromListeners(int ProducerCount, int TriggersPerProducer)
+    {
+        Syn::ConcurrentEvent<int> first;
+        Syn::ConcurrentEvent<float> second;
+        Counter firstWrites;
+        Counter secondWrites;
+
+        first.Register([&second, &firstWrites](int)
+        {
+            const Syn::EventHandle handle = second.Register([](float) {});
+            second.Unregister(handle);
+            ++firstWrites.value;
+        });
+        second.Register([&first, &secondWrites](float)
+        {
+            const Syn::EventHandle handle = first.Register([](int) {});
+            first.Unregister(handle);
+            ++secondWrites.value;
+        });
+
+        std::vector<std::thread> producers;
+        for (int i = 0; i < ProducerCount; ++i)
+        {
+            producers.emplace_back([&, i]()
+            {
+                for (int j = 0; j < TriggersPerProducer; ++j)
+                {
+                    if (i % 2 == 0)
+                    {
+                        first.Trigger(1);
+                    }
+                    else
+                    {
+                        second.Trigger(1.0f);
+                    }
+                }
+            });
+        }
+
+        for (std::thread& producer : producers)
+        {
+            producer.join();
+        }
+
+        first.Synchronize();
+        second.Synchronize();
+
+        const int firstProducers = (ProducerCount + 1) / 2;
+        const int secondProducers = ProducerCount / 2;
+        Check(firstWrites.value.load() == int64_t(firstProducers) * TriggersPerProducer, "First event missed triggers");
+        Check(secondWrites.value.load() == int64_t(secondProducers) * TriggersPerProducer, "Second event missed triggers");
+        Check(first.RefCount() == 1 && second.RefCount() == 1, "Listeners registered from listeners were not removed");
+        std::printf("Cross event writes from listeners : %d producers, %d triggers each\n", ProducerCount, TriggersPerProducer);
+    }
+}
+
+int main(int argc, char** argv)
+{
+    const int producerCount = argc > 1 ? std::atoi(argv[1]) : std::max(4, int(std::thread::hardware_concurrency()));
+    const int triggersPerProducer = argc > 2 ? std::atoi(argv[2]) : 20000;
+
+    const auto start = std::chrono::steady_clock::now();
+    ProducersWithChurningListeners(producerCount, triggersPerProducer);
+    CrossEventWritesFromListeners(producerCount, triggersPerProducer / 10);
+    const auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::printf("%s in %.2fs\n", failures == 0 ? "Passed" : "Failed", elapsed);
+    return failures == 0 ? 0 : 1;
+}
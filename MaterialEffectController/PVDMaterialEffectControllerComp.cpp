@@ -3,19 +3,32 @@
 #include "GESDataTypes.h"
 #include "GESHandler.h"
 #include "Camera/CameraComponent.h"
+#include "Curves/CurveFloat.h"
 #include "Curves/CurveLinearColor.h"
 #include "PVD/Characters/PVDCharacter.h"
 #include "Components/ActorComponent.h"
+#include "Algo/BinarySearch.h"
 #include "PVD/Data/MaterialEffectConfigDataAsset.h"
+#include "PVDMaterialEffectSubsystem.h"
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Parameter Writes"), STAT_MatFXParameterWrites, STATGROUP_MatFX);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Skipped Parameter Writes"), STAT_MatFXSkippedParameterWrites, STATGROUP_MatFX);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Coalesced Triggers"), STAT_MatFXCoalescedTriggers, STATGROUP_MatFX);
 
 UPVDMaterialEffectControllerComp::UPVDMaterialEffectControllerComp()
 {
-	PrimaryComponentTick.bCanEverTick = true;
+	PrimaryComponentTick.bCanEverTick = false;
 }
 
 void UPVDMaterialEffectControllerComp::BeginPlay()
 {
 	Super::BeginPlay();
+
+	if (UPVDMaterialEffectSubsystem* MaterialEffectSubsystem = GetWorld()->GetSubsystem<UPVDMaterialEffectSubsystem>())
+	{
+		MaterialEffectSubsystemPtr = MakeWeakObjectPtr(MaterialEffectSubsystem);
+		MaterialEffectSubsystem->RegisterController(this);
+	}
 	
 	/* Bind configs with GES events */
 	CategorizeConfigsWithEvents();
@@ -31,77 +44,176 @@ void UPVDMaterialEffectControllerComp::EndPlay(const EEndPlayReason::Type EndPla
 
 	/** Unbind from GES events */ 
 	FGESHandler::DefaultHandler()->RemoveAllListenersForReceiver(this);
-}
 
-void UPVDMaterialEffectControllerComp::TickComponent(float DeltaTime, ELevelTick TickType,
-                                                     FActorComponentTickFunction* ThisTickFunction)
-{
-	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+	for (FParameterChangeChannel& Channel : ParameterChangeChannels)
+	{
+		ReturnChannelMaterialInstance(Channel);
+	}
 
-	ProcessMaterialsChanges(DeltaTime);
-	ProcessParameterChanges(DeltaTime);
+	if (MaterialEffectSubsystemPtr.IsValid())
+	{
+		MaterialEffectSubsystemPtr->UnregisterController(this);
+	}
 }
 
 /** Trigger setup and run */
 void UPVDMaterialEffectControllerComp::CategorizeConfigsWithEvents()
 {
-	for (auto DataAssetConfigList : DataAssetConfigs)
+	/** Inline configs are per actor, only data asset configs can be shared */
+	if (Configs.IsEmpty() && MaterialEffectSubsystemPtr.IsValid())
 	{
-		for (auto Config : DataAssetConfigList->ConfigList)
-		{
-			Configs.Add(Config);
-		}
+		CompiledConfigs = MaterialEffectSubsystemPtr->FindOrCompileConfigs(DataAssetConfigs);
 	}
-	
-	for (auto Config : Configs)
+	else
 	{
-		if(!EventConfigMap.Contains(Config.GlobalEventType))
+		TArray<const FMaterialEffectConfig*> SourceConfigs;
+		for (const FMaterialEffectConfig& Config : Configs)
 		{
-			EventConfigMap.Add(Config.GlobalEventType);
+			SourceConfigs.Add(&Config);
 		}
-		
-		EventConfigMap[Config.GlobalEventType].Configs.Add(Config);
+		for (auto DataAssetConfigList : DataAssetConfigs)
+		{
+			for (const FMaterialEffectConfig& Config : DataAssetConfigList->ConfigList)
+			{
+				SourceConfigs.Add(&Config);
+			}
+		}
+
+		const TSharedRef<FMatFXCompiledConfigs> LocalConfigs = MakeShared<FMatFXCompiledConfigs>();
+		LocalConfigs->Build(SourceConfigs);
+		CompiledConfigs = LocalConfigs;
+	}
 
-		GES_MATERIAL_EFFECT_EVENT_CONTEXT(Config.GlobalEventType);
-		FGESHandler::DefaultHandler()->AddLambdaListener(GESEventContext, [this,Config] (UObject* InTarget)
+	/** Resolved up front so the first trigger of each effect does not pay for it */
+	ConfigTargetCache.Reset();
+	ConfigTargetCache.SetNum(CompiledConfigs->Configs.Num());
+	InvalidateTargetCache();
+
+	/** One listener per event, however many configs it runs */
+	for (int32 EventIndex = 0; EventIndex < CompiledConfigs->EventConfigRanges.Num(); ++EventIndex)
+	{
+		if (CompiledConfigs->EventConfigRanges[EventIndex].Num == 0)
+			continue;
+
+		const EMatFXGlobalEvent EventType = static_cast<EMatFXGlobalEvent>(EventIndex);
+		GES_MATERIAL_EFFECT_EVENT_CONTEXT(EventType);
+		FGESHandler::DefaultHandler()->AddLambdaListener(GESEventContext, [this, EventType] (UObject* InTarget)
 		{
 			if(InTarget == GetOwner())
 			{
-				Run(EventConfigMap[Config.GlobalEventType].Configs);
-				OnConfigRunnedWithGES.Broadcast(Config.GlobalEventType);
+				RunEvent(EventType);
+				OnConfigRunnedWithGES.Broadcast(EventType);
 			}
 		});
 	}
 }
 
-void UPVDMaterialEffectControllerComp::RunConfigWithParameter(EMatFXGlobalEvent Type)
+void FMatFXCompiledConfigs::Build(const TArray<const FMaterialEffectConfig*>& SourceConfigs)
+{
+	/** Counting sort by event, configs of one event keep their authored order */
+	int32 NumEvents = 0;
+	for (const FMaterialEffectConfig* Config : SourceConfigs)
+	{
+		NumEvents = FMath::Max(NumEvents, static_cast<int32>(Config->GlobalEventType) + 1);
+	}
+
+	EventConfigRanges.Init(FMatFXEventConfigRange(), NumEvents);
+	for (const FMaterialEffectConfig* Config : SourceConfigs)
+	{
+		++EventConfigRanges[static_cast<int32>(Config->GlobalEventType)].Num;
+	}
+
+	int32 Start = 0;
+	for (FMatFXEventConfigRange& Range : EventConfigRanges)
+	{
+		Range.Start = Start;
+		Start += Range.Num;
+		Range.Num = 0;
+	}
+
+	Configs.SetNum(SourceConfigs.Num());
+	for (const FMaterialEffectConfig* Config : SourceConfigs)
+	{
+		FMatFXEventConfigRange& Range = EventConfigRanges[static_cast<int32>(Config->GlobalEventType)];
+		const int32 ConfigIndex = Range.Start + Range.Num++;
+
+		FMaterialEffectConfig& CompiledConfig = Configs[ConfigIndex];
+		CompiledConfig = *Config;
+		CompiledConfig.TargetCacheIndex = ConfigIndex;
+
+		for (const FString& MeshName : CompiledConfig.EffectedMeshNameList)
+		{
+			CompiledConfig.EffectedMeshNames.Add(FName(*MeshName));
+		}
+		for (const FString& MeshName : CompiledConfig.ExcludedMeshNameList)
+		{
+			CompiledConfig.ExcludedMeshNames.Add(FName(*MeshName));
+		}
+		CompiledConfig.EffectedMeshNameList.Empty();
+		CompiledConfig.ExcludedMeshNameList.Empty();
+
+		for (FMaterialParameterChangeConfig& ParameterConfig : CompiledConfig.ParameterConfigs)
+		{
+			ParameterConfig.BakeCurve();
+		}
+	}
+}
+
+SIZE_T FMatFXCompiledConfigs::GetAllocatedSize() const
 {
-	for (auto Config : Configs)
+	SIZE_T AllocatedSize = Configs.GetAllocatedSize() + EventConfigRanges.GetAllocatedSize();
+	for (const FMaterialEffectConfig& Config : Configs)
 	{
-		if (Config.GlobalEventType == Type)
+		AllocatedSize += Config.EffectedMeshNames.GetAllocatedSize() + Config.ExcludedMeshNames.GetAllocatedSize()
+			+ Config.EffectedSlotIds.GetAllocatedSize() + Config.ParameterConfigs.GetAllocatedSize();
+		for (const FMaterialParameterChangeConfig& ParameterConfig : Config.ParameterConfigs)
 		{
-			Run(EventConfigMap[Config.GlobalEventType].Configs);
+			if (ParameterConfig.BakedCurve.IsValid())
+			{
+				AllocatedSize += ParameterConfig.BakedCurve->FloatSamples.GetAllocatedSize()
+					+ ParameterConfig.BakedCurve->ColorSamples.GetAllocatedSize();
+			}
 		}
 	}
+	return AllocatedSize;
+}
+
+void UPVDMaterialEffectControllerComp::RunConfigWithParameter(EMatFXGlobalEvent Type)
+{
+	RunEvent(Type);
 }
 
-void UPVDMaterialEffectControllerComp::Run(TArray<FMaterialEffectConfig> ConfigArray)
+void UPVDMaterialEffectControllerComp::RunEvent(EMatFXGlobalEvent Type)
 {
-	for (FMaterialEffectConfig Config : ConfigArray)
+	const int32 EventIndex = static_cast<int32>(Type);
+	if (!CompiledConfigs.IsValid() || !CompiledConfigs->EventConfigRanges.IsValidIndex(EventIndex))
+		return;
+
+	const FMatFXEventConfigRange& Range = CompiledConfigs->EventConfigRanges[EventIndex];
+	for (int32 ConfigIndex = Range.Start; ConfigIndex < Range.Start + Range.Num; ++ConfigIndex)
 	{
-		Run(Config);
+		Run(CompiledConfigs->Configs[ConfigIndex]);
 	}
 }
 
-void UPVDMaterialEffectControllerComp::Run(FMaterialEffectConfig& Config)
+void UPVDMaterialEffectControllerComp::Run(const FMaterialEffectConfig& Config)
 {
-	TArray<UMeshComponent*> MeshComponents = GetMeshes(Config);
+	const TArray<FMatFXTarget>& Targets = GetConfigTargets(Config);
+
+	/** Targets are not polled for changes, a mesh gone since they were resolved is the one thing noticed here */
+	bool bHasStaleTarget = false;
+	for (const FMatFXTarget& Target : Targets)
+	{
+		const UMeshComponent* MeshComponent = Target.Mesh.Get();
+		bHasStaleTarget |= MeshComponent == nullptr || !MeshComponent->IsRegistered();
+	}
+
 	switch (Config.MaterialEffectType)
 	{
 	case EMaterialEffectType::OverrideMaterial:
-		for (UMeshComponent* MeshComponent : MeshComponents)
+		for (const FMatFXTarget& Target : Targets)
 		{
-			CreateMaterialChangeHandler(Config, Config.EffectMaterial, MeshComponent);
+			CreateMaterialChangeHandler(Config, Config.EffectMaterial, Target);
 		}
 		break;
 	case EMaterialEffectType::ChangeParameters:
@@ -109,160 +221,395 @@ void UPVDMaterialEffectControllerComp::Run(FMaterialEffectConfig& Config)
 		{
 			SetParametersOfPostProcessMaterials(Config);
 		}
-		for (UMeshComponent* MeshComponent : MeshComponents)
+		for (int32 TargetIndex = 0; TargetIndex < Targets.Num(); ++TargetIndex)
 		{
-			CreateParameterChangeHandler(Config, MeshComponent);
+			const bool bFirstTargetOfMesh = TargetIndex == 0 || Targets[TargetIndex - 1].Mesh != Targets[TargetIndex].Mesh;
+			CreateParameterChangeHandler(Config, Targets[TargetIndex], bFirstTargetOfMesh);
 		}
 		break;
 	}
+
+	if (bHasStaleTarget)
+	{
+		InvalidateTargetCache();
+	}
+
+	if (HasActiveHandlers() && MaterialEffectSubsystemPtr.IsValid())
+	{
+		MaterialEffectSubsystemPtr->ActivateController(this);
+	}
 }
 
-void UPVDMaterialEffectControllerComp::ProcessParameterChanges(float DeltaTime)
+/** Largest difference from the curve asset a baked curve may have, about a tenth of an 8 bit color step */
+static constexpr float MatFXCurveBakeTolerance = 1.0f / 2048.0f;
+
+/** Constant keys jump between samples, interpolating samples would smear the step */
+static bool HasConstantKeys(const FRichCurve& Curve)
 {
-	for (auto ParameterChangeHandlers : ParameterChangeHandlersMap)
+	for (const FRichCurveKey& Key : Curve.GetConstRefOfKeys())
 	{
-		UParameterChangeHandler* PriorParameterChangeHandler = EvaluatePriorParameterChangeHandler(ParameterChangeHandlers);
-
-		if (PriorParameterChangeHandler == nullptr)
+		if (Key.InterpMode == RCIM_Constant)
 		{
-			continue;
+			return true;
 		}
-		
-		GarbageCollectionCheckForParameterChanges(ParameterChangeHandlers, PriorParameterChangeHandler);
+	}
+	return false;
+}
 
-		for(auto ParameterChangeHandler : ParameterChangeHandlers.Value->Array)
+void FMaterialParameterChangeConfig::BakeCurve()
+{
+	BakedCurve.Reset();
+
+	if (!IsAnimation || CurveBakeResolution <= 0)
+		return;
+
+	const TSharedRef<FMatFXCurveLUT> CurveLUT = MakeShared<FMatFXCurveLUT>();
+	const int32 NumSamples = CurveBakeResolution + 1;
+
+	/** Compared between samples too, where the lerp is furthest from the samples it was built from */
+	const float CheckOffsets[] = {0.25f, 0.5f, 0.75f};
+
+	switch (ParameterType)
+	{
+	case EMaterialParamType::Float:
+		if (FloatCurve == nullptr || HasConstantKeys(FloatCurve->FloatCurve))
+			return;
+		CurveLUT->FloatSamples.SetNumUninitialized(NumSamples);
+		for (int32 Index = 0; Index < NumSamples; ++Index)
 		{
-			if (ParameterChangeHandler->MaterialInstance == nullptr)
+			CurveLUT->FloatSamples[Index] = FloatCurve->GetFloatValue(static_cast<float>(Index) / CurveBakeResolution);
+		}
+		for (int32 Index = 0; Index < CurveBakeResolution; ++Index)
+		{
+			for (const float Offset : CheckOffsets)
 			{
-				InitialSetupParameterChangeHandler(ParameterChangeHandler);
+				const float Time = (Index + Offset) / CurveBakeResolution;
+				if (FMath::Abs(CurveLUT->SampleFloat(Time) - FloatCurve->GetFloatValue(Time)) > MatFXCurveBakeTolerance)
+					return;
 			}
-
-			//Process Delay Timer
-			if (ParameterChangeHandler->Config.Delay > 0 && ParameterChangeHandler->Config.HasDelay)
+		}
+		break;
+	case EMaterialParamType::Color:
+		if (ColorCurve == nullptr)
+			return;
+		for (const FRichCurve& ChannelCurve : ColorCurve->FloatCurves)
+		{
+			if (HasConstantKeys(ChannelCurve))
+				return;
+		}
+		CurveLUT->ColorSamples.SetNumUninitialized(NumSamples);
+		for (int32 Index = 0; Index < NumSamples; ++Index)
+		{
+			CurveLUT->ColorSamples[Index] = ColorCurve->GetLinearColorValue(static_cast<float>(Index) / CurveBakeResolution);
+		}
+		for (int32 Index = 0; Index < CurveBakeResolution; ++Index)
+		{
+			for (const float Offset : CheckOffsets)
 			{
-				if (ParameterChangeHandler->DelayCounter < ParameterChangeHandler->Config.Delay)
-				{
-					ParameterChangeHandler->DelayCounter += DeltaTime;
-					continue;
-				}
+				const float Time = (Index + Offset) / CurveBakeResolution;
+				const FLinearColor Difference = CurveLUT->SampleColor(Time) - ColorCurve->GetLinearColorValue(Time);
+				if (FMath::Max(FMath::Max(FMath::Abs(Difference.R), FMath::Abs(Difference.G)),
+				               FMath::Max(FMath::Abs(Difference.B), FMath::Abs(Difference.A))) > MatFXCurveBakeTolerance)
+					return;
 			}
+		}
+		break;
+	default:
+		return;
+	}
 
-			//Check lifetime and killflag
-			if (ParameterChangeHandler->Config.Lifetime > 0 && ParameterChangeHandler->Config.HasLifetime)
-			{
-				if (ParameterChangeHandler->LifetimeCounter < ParameterChangeHandler->Config.Lifetime)
-				{
-					ParameterChangeHandler->LifetimeCounter += DeltaTime;
-				}
-				else
-				{
-					ParameterChangeHandler->bKillFlag = true;
-					continue;
-				}
-			}
+	BakedCurve = CurveLUT;
+}
 
-			//Apply config if its prior one
-			if(ParameterChangeHandler->ParentConfig == PriorParameterChangeHandler->ParentConfig)
-			{
-				ApplyParameterChange(ParameterChangeHandler);
-			}
+void UPVDMaterialEffectControllerComp::PrepareParameterChanges()
+{
+	/** Channel pass, removes finished handlers and resolves the prior handler only where membership changed */
+	for (FParameterChangeChannel& Channel : ParameterChangeChannels)
+	{
+		if (Channel.Array.IsEmpty())
+		{
+			continue;
+		}
 
-			//Increase animation timer anyway
-			if(ParameterChangeHandler->Config.IsAnimation)
-			{
-				ParameterChangeHandler->AnimationCounter += DeltaTime;
-			}
+		GarbageCollectionCheckForParameterChanges(Channel);
+
+		if (Channel.bPriorDirty)
+		{
+			EvaluatePriorParameterChangeHandler(Channel);
+		}
+	}
+}
+
+void UPVDMaterialEffectControllerComp::AdvanceParameterChangeTimings(float DeltaTime)
+{
+	/** Timing pass, delay, lifetime and animation counters of all handlers at once */
+	PendingParameterWrites.Reset();
+	ParameterChangeTimings.Advance(DeltaTime, Significance == EMatFXSignificance::Low, PendingParameterWrites);
+}
+
+void UPVDMaterialEffectControllerComp::ApplyParameterChanges()
+{
+	/** Write pass, only handlers whose output changed touch their material instance */
+	for (const int32 HandlerIndex : PendingParameterWrites)
+	{
+		ApplyParameterChange(ParameterChangeHandlerPool[HandlerIndex], ParameterChangeTimings.CurveTime[HandlerIndex]);
+	}
+}
+
+void FParameterChangeTimings::Start(const int32 Index, const FMaterialParameterChangeConfig& Config)
+{
+	const bool bAnimation = Config.IsAnimation && Config.ParameterType != EMaterialParamType::Texture && Config.AnimationTime > 0;
+
+	Delay[Index] = Config.Delay > 0 && Config.HasDelay ? Config.Delay : 0;
+	DelayCounter[Index] = 0;
+	Lifetime[Index] = Config.Lifetime > 0 && Config.HasLifetime ? Config.Lifetime : MAX_flt;
+	LifetimeCounter[Index] = 0;
+	AnimationCounter[Index] = 0;
+	InvAnimationTime[Index] = bAnimation ? 1.0f / Config.AnimationTime : 0;
+	CurveTime[Index] = 0;
+	LastCurveTime[Index] = -1;
+	Changed[Index] = 0;
+	Flags[Index] = static_cast<uint8>(MatFXTimingFlags::Active
+		| (bAnimation ? MatFXTimingFlags::Animation : 0)
+		| (bAnimation && Config.bLoopAnimation ? MatFXTimingFlags::Loop : 0));
+}
+
+void FParameterChangeTimings::Advance(const float DeltaTime, const bool bSkipAnimation, TArray<int32>& OutChangedHandlers)
+{
+	const int32 Num = Flags.Num();
+
+	for (int32 Index = 0; Index < Num; ++Index)
+	{
+		const uint8 HandlerFlags = Flags[Index];
+		const bool bActive = (HandlerFlags & MatFXTimingFlags::Active) != 0;
+		const bool bInDelay = DelayCounter[Index] < Delay[Index];
+		const bool bExpired = !bInDelay & (LifetimeCounter[Index] >= Lifetime[Index]);
+		const bool bRunning = bActive & !bInDelay & !bExpired;
+		const bool bAnimation = (HandlerFlags & MatFXTimingFlags::Animation) != 0;
+		const bool bLoop = (HandlerFlags & MatFXTimingFlags::Loop) != 0;
+		const bool bPrior = (HandlerFlags & MatFXTimingFlags::Prior) != 0;
+
+		DelayCounter[Index] += bActive & bInDelay ? DeltaTime : 0.0f;
+		LifetimeCounter[Index] += bRunning ? DeltaTime : 0.0f;
+
+		/** Curve time is sampled before the animation counter moves, like the handler did */
+		const float Time = AnimationCounter[Index] * InvAnimationTime[Index];
+		const float SampledCurveTime = bLoop ? Time - FMath::FloorToFloat(Time) : FMath::Min(Time, 1.0f);
+		const float SkippedCurveTime = bLoop ? CurveTime[Index] : (bAnimation ? 1.0f : SampledCurveTime);
+		const float NewCurveTime = bSkipAnimation ? SkippedCurveTime : SampledCurveTime;
+		AnimationCounter[Index] += bRunning & bAnimation ? DeltaTime : 0.0f;
+
+		const bool bChanged = bRunning & bPrior & (NewCurveTime != LastCurveTime[Index]);
+		CurveTime[Index] = NewCurveTime;
+		LastCurveTime[Index] = bChanged ? NewCurveTime : LastCurveTime[Index];
+		Changed[Index] = bChanged;
+		Flags[Index] = static_cast<uint8>(HandlerFlags | (bActive & bExpired ? MatFXTimingFlags::Expired : 0));
+	}
+
+	for (int32 Index = 0; Index < Num; ++Index)
+	{
+		if (Changed[Index])
+		{
+			OutChangedHandlers.Add(Index);
 		}
 	}
 }
 
-const bool UPVDMaterialEffectControllerComp::CreateParameterChangeHandler(FMaterialEffectConfig& Config,
-																	  UMeshComponent* MeshComponent)
+const bool UPVDMaterialEffectControllerComp::CreateParameterChangeHandler(const FMaterialEffectConfig& Config,
+																	  const FMatFXTarget& Target,
+																	  bool bFirstTargetOfMesh)
 {
-	TArray<FName> SlotNames = MeshComponent->GetMaterialSlotNames();
+	UMeshComponent* MeshComponent = Target.Mesh.Get();
+	if (MeshComponent == nullptr)
+		return false;
 
-	for (size_t index = 0; index < SlotNames.Num(); ++index)
+	for (int32 ParameterIndex = 0; ParameterIndex < Config.ParameterConfigs.Num(); ++ParameterIndex)
 	{
-		if (!Config.EffectedSlotIds.Contains(index) && !Config.EffectAllSlots && !Config.IsOverlaySlot)
+		const FMaterialParameterChangeConfig& ParameterConfig = Config.ParameterConfigs[ParameterIndex];
+
+		/** One handler and channel per mesh and data index, slots of the mesh would all write the same value */
+		uint32 ChannelKey = Target.ChannelKey;
+		if (ParameterConfig.UsesCustomPrimitiveData())
+		{
+			if (!bFirstTargetOfMesh)
+				continue;
+			ChannelKey = MatFXChannelKey::Make(MatFXChannelKey::MeshIndexOf(Target.ChannelKey),
+				MatFXChannelKey::CustomPrimitiveDataSlotId(ParameterConfig.CustomPrimitiveDataIndex));
+		}
+
+		if (RetriggerParameterChangeHandler(Config, ParameterIndex, ChannelKey))
 			continue;
-		for (FMaterialParameterChangeConfig ParameterConfig : Config.ParameterConfigs)
+
+		const int32 HandlerIndex = AllocateParameterChangeHandler();
+		FParameterChangeHandler& ParameterChangeHandler = ParameterChangeHandlerPool[HandlerIndex];
+		ParameterChangeHandler.Config = ParameterConfig;
+		ParameterChangeHandler.ParentConfig = &Config;
+		ParameterChangeHandler.ParameterIndex = ParameterIndex;
+		ParameterChangeHandler.TriggerSerial = NextParameterTriggerSerial++;
+		ParameterChangeHandler.EffectedMesh = MeshComponent;
+		ParameterChangeHandler.IsOverlaySlot = Config.IsOverlaySlot;
+		ParameterChangeHandler.Priority = Config.Priority;
+		ParameterChangeHandler.SlotId = Target.SlotId;
+		ParameterChangeHandler.ChannelKey = ChannelKey;
+		ParameterChangeHandler.bUseCustomPrimitiveData = ParameterChangeHandler.Config.UsesCustomPrimitiveData();
+
+		if(Config.bHasFinisherEvent)
 		{
-			UParameterChangeHandler* ParameterChangeHandler = NewObject<UParameterChangeHandler>();
-			ParameterChangeHandler->Config = ParameterConfig;
-			ParameterChangeHandler->ParentConfig = &Config;
-			ParameterChangeHandler->EffectedMesh = MeshComponent;
-			ParameterChangeHandler->IsOverlaySlot = Config.IsOverlaySlot;
-			ParameterChangeHandler->Priority = Config.Priority;
-			ParameterChangeHandler->SlotId = index;
+			GES_MATERIAL_EFFECT_EVENT_CONTEXT(Config.FinisherEventType);
 
-			if(Config.bHasFinisherEvent)
+			TWeakObjectPtr<UPVDMaterialEffectControllerComp> WeakThis = MakeWeakObjectPtr(this);
+			const uint32 Generation = ParameterChangeHandler.Generation;
+			ParameterChangeHandler.EventContext = GESEventContext;
+			ParameterChangeHandler.LambdaName = FGESHandler::DefaultHandler()->AddLambdaListener(GESEventContext, [WeakThis, HandlerIndex, Generation]()
 			{
-				GES_MATERIAL_EFFECT_EVENT_CONTEXT(Config.FinisherEventType);
-
-				TWeakObjectPtr<UParameterChangeHandler> WeakParameterChangeHandler = MakeWeakObjectPtr(ParameterChangeHandler);
-				ParameterChangeHandler->EventContext = GESEventContext;
-				ParameterChangeHandler->LambdaName = FGESHandler::DefaultHandler()->AddLambdaListener(GESEventContext, [WeakParameterChangeHandler]()
+				if(WeakThis.IsValid())
 				{
-					if(WeakParameterChangeHandler.IsValid())
-					{
-						WeakParameterChangeHandler->bKillFlag = true;
-					}
-				});
-			}
-			
-			FString KeyName = FString(MeshComponent->GetName() + (Config.IsOverlaySlot ? "-1" : FString::FromInt(index)));
-			
-			if(!ParameterChangeHandlersMap.Contains(KeyName))
+					WeakThis->KillParameterChangeHandler(HandlerIndex, Generation);
+				}
+			});
+		}
+		
+		ParameterChangeTimings.Start(HandlerIndex, ParameterChangeHandler.Config);
+		AddToParameterChangeChannel(ChannelKey, HandlerIndex);
+	}
+	return true;
+}
+
+bool UPVDMaterialEffectControllerComp::RetriggerParameterChangeHandler(const FMaterialEffectConfig& Config,
+                                                                       int32 ParameterIndex, uint32 ChannelKey)
+{
+	if (Config.RetriggerPolicy == EMatFXRetriggerPolicy::Stack && Config.MaxStack <= 0)
+		return false;
+
+	const int32 ChannelIndex = ParameterChangeChannelTable.Find(ChannelKey);
+	if (ChannelIndex == INDEX_NONE)
+		return false;
+
+	/** Restarts keep the channel position, so the oldest handler is found by trigger serial, not by order */
+	FParameterChangeChannel& Channel = ParameterChangeChannels[ChannelIndex];
+	int32 OldestHandlerIndex = INDEX_NONE;
+	int32 NumRunning = 0;
+	for (const int32 HandlerIndex : Channel.Array)
+	{
+		const FParameterChangeHandler& ParameterChangeHandler = ParameterChangeHandlerPool[HandlerIndex];
+		if (ParameterChangeHandler.ParentConfig == &Config && ParameterChangeHandler.ParameterIndex == ParameterIndex
+			&& !ParameterChangeHandler.bKillFlag && !ParameterChangeTimings.IsExpired(HandlerIndex))
+		{
+			if (NumRunning == 0 || static_cast<int32>(ParameterChangeHandler.TriggerSerial
+				- ParameterChangeHandlerPool[OldestHandlerIndex].TriggerSerial) < 0)
 			{
-				ParameterChangeHandlersMap.Add(KeyName, NewObject<UParameterChangeHandlerArray>());
+				OldestHandlerIndex = HandlerIndex;
 			}
-
-			ParameterChangeHandlersMap[KeyName]->Array.Add(ParameterChangeHandler);
-			ParameterChangeHandlersMap[KeyName]->Array.Sort();
+			++NumRunning;
 		}
 	}
+
+	if (NumRunning == 0 || (Config.RetriggerPolicy == EMatFXRetriggerPolicy::Stack && NumRunning < Config.MaxStack))
+		return false;
+
+	switch (Config.RetriggerPolicy)
+	{
+	case EMatFXRetriggerPolicy::Stack:
+	case EMatFXRetriggerPolicy::Restart:
+		/** Restarts in place, moving the handler behind equal priorities of other configs would hide the effect */
+		ParameterChangeTimings.Restart(OldestHandlerIndex, ParameterChangeHandlerPool[OldestHandlerIndex].Config);
+		ParameterChangeHandlerPool[OldestHandlerIndex].TriggerSerial = NextParameterTriggerSerial++;
+		break;
+	case EMatFXRetriggerPolicy::ExtendLifetime:
+		ParameterChangeTimings.ExtendLifetime(OldestHandlerIndex);
+		break;
+	case EMatFXRetriggerPolicy::IgnoreWhileActive:
+		break;
+	}
+
+	INC_DWORD_STAT(STAT_MatFXCoalescedTriggers);
 	return true;
 }
 
-void UPVDMaterialEffectControllerComp::InitialSetupParameterChangeHandler(UParameterChangeHandler* ParameterChangeHandler)
+int32 UPVDMaterialEffectControllerComp::AllocateParameterChangeHandler()
+{
+	int32 HandlerIndex;
+	if (FreeParameterChangeHandlers.Num() > 0)
+	{
+		HandlerIndex = FreeParameterChangeHandlers.Pop(false);
+	}
+	else
+	{
+		HandlerIndex = ParameterChangeHandlerPool.AddDefaulted();
+		ParameterChangeTimings.AddDefaulted();
+	}
+
+	ParameterChangeHandlerPool[HandlerIndex].bInUse = true;
+	return HandlerIndex;
+}
+
+void UPVDMaterialEffectControllerComp::ReleaseParameterChangeHandler(int32 HandlerIndex)
+{
+	FParameterChangeHandler& ParameterChangeHandler = ParameterChangeHandlerPool[HandlerIndex];
+	const uint32 NextGeneration = ParameterChangeHandler.Generation + 1;
+
+	/** Drop the UObject references so the pool does not keep materials alive */
+	ParameterChangeHandler = FParameterChangeHandler();
+	ParameterChangeHandler.Generation = NextGeneration;
+	ParameterChangeTimings.Stop(HandlerIndex);
+	FreeParameterChangeHandlers.Add(HandlerIndex);
+}
+
+void UPVDMaterialEffectControllerComp::KillParameterChangeHandler(int32 HandlerIndex, uint32 Generation)
+{
+	if (!ParameterChangeHandlerPool.IsValidIndex(HandlerIndex))
+		return;
+
+	FParameterChangeHandler& ParameterChangeHandler = ParameterChangeHandlerPool[HandlerIndex];
+	if (ParameterChangeHandler.bInUse && ParameterChangeHandler.Generation == Generation)
+	{
+		ParameterChangeHandler.bKillFlag = true;
+	}
+}
+
+void UPVDMaterialEffectControllerComp::InitialSetupParameterChangeHandler(FParameterChangeHandler& ParameterChangeHandler)
 {
-	ParameterChangeHandler->MaterialInstance = CreateDynamicMaterialInstance(ParameterChangeHandler);
+	if (!ParameterChangeHandler.bUseCustomPrimitiveData)
+	{
+		ParameterChangeHandler.MaterialInstance = CreateDynamicMaterialInstance(ParameterChangeHandler);
+		if (ParameterChangeHandler.MaterialInstance == nullptr)
+			return;
+	}
+	ParameterChangeHandler.bIsSetUp = true;
 
-	switch (ParameterChangeHandler->Config.ParameterType)
+	switch (ParameterChangeHandler.Config.ParameterType)
 	{
 	case EMaterialParamType::Float:
-		ParameterChangeHandler->OldFloatValue = ParameterChangeHandler->MaterialInstance->K2_GetScalarParameterValue(
-			ParameterChangeHandler->Config.ParameterName);
-		if(ParameterChangeHandler->Config.ReturnToDefaultValue)
+		ParameterChangeHandler.OldFloatValue = GetCurrentScalarValue(ParameterChangeHandler);
+		if(ParameterChangeHandler.Config.ReturnToDefaultValue)
 		{
-			ParameterChangeHandler->OldFloatValue = ParameterChangeHandler->Config.DefaultValue;
+			ParameterChangeHandler.OldFloatValue = ParameterChangeHandler.Config.DefaultValue;
 		}
-		switch (ParameterChangeHandler->Config.ParameterChangeType)
+		switch (ParameterChangeHandler.Config.ParameterChangeType)
 		{
 		case EMaterialParameterChangeType::Additive:
-			ParameterChangeHandler->Config.FloatParameterValue += ParameterChangeHandler->
+			ParameterChangeHandler.Config.FloatParameterValue += ParameterChangeHandler.
 				OldFloatValue;
 			break;
 
 		case EMaterialParameterChangeType::Multiply:
-			ParameterChangeHandler->Config.FloatParameterValue *= ParameterChangeHandler->
+			ParameterChangeHandler.Config.FloatParameterValue *= ParameterChangeHandler.
 				OldFloatValue;
 			break;
 		}
 		break;
 
 	case EMaterialParamType::Color:
-		ParameterChangeHandler->OldLinearColorValue = ParameterChangeHandler->MaterialInstance->K2_GetVectorParameterValue(
-			ParameterChangeHandler->Config.ParameterName);
+		ParameterChangeHandler.OldLinearColorValue = GetCurrentVectorValue(ParameterChangeHandler);
 
-		switch (ParameterChangeHandler->Config.ParameterChangeType)
+		switch (ParameterChangeHandler.Config.ParameterChangeType)
 		{
 		case EMaterialParameterChangeType::Additive:
-			ParameterChangeHandler->Config.LinearColorParameterValue += ParameterChangeHandler->
+			ParameterChangeHandler.Config.LinearColorParameterValue += ParameterChangeHandler.
 				OldLinearColorValue;
 			break;
 		case EMaterialParameterChangeType::Multiply:
-			ParameterChangeHandler->Config.LinearColorParameterValue *= ParameterChangeHandler->
+			ParameterChangeHandler.Config.LinearColorParameterValue *= ParameterChangeHandler.
 				OldLinearColorValue;
 			break;
 		}
@@ -270,166 +617,210 @@ void UPVDMaterialEffectControllerComp::InitialSetupParameterChangeHandler(UParam
 		break;
 
 	case EMaterialParamType::Texture:
-		ParameterChangeHandler->OldTextureValue = ParameterChangeHandler->MaterialInstance->K2_GetTextureParameterValue(
-			ParameterChangeHandler->Config.ParameterName);
+		ParameterChangeHandler.OldTextureValue = ParameterChangeHandler.MaterialInstance->K2_GetTextureParameterValue(
+			ParameterChangeHandler.Config.ParameterName);
 		break;
 	}
 }
 
-UParameterChangeHandler* UPVDMaterialEffectControllerComp::EvaluatePriorParameterChangeHandler(TTuple<FString, UParameterChangeHandlerArray*> ParameterChangeHandlers)
+FParameterChangeChannel& UPVDMaterialEffectControllerComp::FindOrAddParameterChangeChannel(uint32 Key)
 {
-	if(!PriorParameterChangeHandlerMap.Contains(ParameterChangeHandlers.Key))
+	int32 ChannelIndex = ParameterChangeChannelTable.Find(Key);
+	if (ChannelIndex == INDEX_NONE)
 	{
-		PriorParameterChangeHandlerMap.Add(ParameterChangeHandlers.Key, NewObject<UParameterChangeHandler>());
+		ChannelIndex = ParameterChangeChannels.AddDefaulted();
+		ParameterChangeChannels[ChannelIndex].Key = Key;
+		ParameterChangeChannelTable.Add(Key, ChannelIndex);
 	}
 
-	UParameterChangeHandler* PriorParameterChangeHandler = nullptr;
-		
-	if(!ParameterChangeHandlers.Value->Array.IsEmpty() &&
-	   ParameterChangeHandlers.Value->Array[0] != PriorParameterChangeHandlerMap[ParameterChangeHandlers.Key])
+	return ParameterChangeChannels[ChannelIndex];
+}
+
+uint16 UPVDMaterialEffectControllerComp::GetChannelMeshIndex(UMeshComponent* MeshComponent)
+{
+	int32 MeshIndex = ChannelMeshComponents.Find(MeshComponent);
+	if (MeshIndex == INDEX_NONE)
 	{
-		if(PriorParameterChangeHandlerMap[ParameterChangeHandlers.Key] != nullptr)
-		{
-			PriorParameterChangeHandlerMap[ParameterChangeHandlers.Key]->ApplyOldValues();
-		}
-		PriorParameterChangeHandlerMap[ParameterChangeHandlers.Key] = ParameterChangeHandlers.Value->Array[0];
-		PriorParameterChangeHandler = ParameterChangeHandlers.Value->Array[0];
+		MeshIndex = ChannelMeshComponents.Add(MeshComponent);
 	}
-	else if(ParameterChangeHandlers.Value->Array.IsEmpty())
+
+	check(MeshIndex < MatFXChannelKey::PostProcessMeshIndex);
+	return static_cast<uint16>(MeshIndex);
+}
+
+void UPVDMaterialEffectControllerComp::AddToParameterChangeChannel(uint32 Key, int32 HandlerIndex)
+{
+	FParameterChangeChannel& Channel = FindOrAddParameterChangeChannel(Key);
+
+	/** Upper bound keeps handlers of equal priority in trigger order */
+	const int32 InsertIndex = Algo::UpperBound(Channel.Array, HandlerIndex, [this](const int32 A, const int32 B)
 	{
-		PriorParameterChangeHandlerMap.Remove(ParameterChangeHandlers.Key);
-	}
-	else
+		return ParameterChangeHandlerPool[A].Priority > ParameterChangeHandlerPool[B].Priority;
+	});
+	Channel.Array.Insert(HandlerIndex, InsertIndex);
+	Channel.bPriorDirty = true;
+}
+
+void UPVDMaterialEffectControllerComp::EvaluatePriorParameterChangeHandler(FParameterChangeChannel& Channel)
+{
+	Channel.bPriorDirty = false;
+
+	const int32 PriorHandlerIndex = Channel.Array.IsEmpty() ? INDEX_NONE : Channel.Array[0];
+	if (PriorHandlerIndex != Channel.PriorParameterChangeHandler)
 	{
-		PriorParameterChangeHandler = ParameterChangeHandlers.Value->Array[0];
+		if (Channel.PriorParameterChangeHandler != INDEX_NONE)
+		{
+			ParameterChangeHandlerPool[Channel.PriorParameterChangeHandler].ApplyOldValues();
+			InvalidateParameterChangeChannel(Channel);
+		}
+		Channel.PriorParameterChangeHandler = PriorHandlerIndex;
 	}
 
-	return PriorParameterChangeHandler;
+	Channel.PriorParentConfig = PriorHandlerIndex != INDEX_NONE
+		? ParameterChangeHandlerPool[PriorHandlerIndex].ParentConfig
+		: nullptr;
+
+	for (const int32 HandlerIndex : Channel.Array)
+	{
+		FParameterChangeHandler& ParameterChangeHandler = ParameterChangeHandlerPool[HandlerIndex];
+
+		if (!ParameterChangeHandler.bIsSetUp)
+		{
+			InitialSetupParameterChangeHandler(ParameterChangeHandler);
+		}
+
+		if (ParameterChangeTimings.SetPrior(HandlerIndex, ParameterChangeHandler.ParentConfig == Channel.PriorParentConfig))
+		{
+			ParameterChangeHandler.bHasWrittenValue = false;
+		}
+	}
 }
 
-float UPVDMaterialEffectControllerComp::CalculateAnimatedParameterConfigCurveTime(UParameterChangeHandler* ParameterChangeHandler)
+void UPVDMaterialEffectControllerComp::InvalidateParameterChangeChannel(const FParameterChangeChannel& Channel)
 {
-	if (ParameterChangeHandler->Config.bLoopAnimation)
-		return NumericMod(ParameterChangeHandler->AnimationCounter, ParameterChangeHandler->Config.AnimationTime) / ParameterChangeHandler->Config.AnimationTime;
-	else
-		return FMath::Clamp(ParameterChangeHandler->AnimationCounter / ParameterChangeHandler->Config.AnimationTime, 0.0f, 1.0f);
+	for (const int32 HandlerIndex : Channel.Array)
+	{
+		ParameterChangeTimings.Invalidate(HandlerIndex);
+		ParameterChangeHandlerPool[HandlerIndex].bHasWrittenValue = false;
+	}
 }
 
-void UPVDMaterialEffectControllerComp::ApplyParameterChange(UParameterChangeHandler* ParameterChangeHandler)
+void UPVDMaterialEffectControllerComp::ApplyParameterChange(FParameterChangeHandler& ParameterChangeHandler, float CurveValueTime)
 {
-	if (ParameterChangeHandler->Config.IsAnimation && ParameterChangeHandler->Config.ParameterType != EMaterialParamType::Texture)
+	const bool bUseCustomPrimitiveData = ParameterChangeHandler.bUseCustomPrimitiveData;
+	if (bUseCustomPrimitiveData ? !IsValid(ParameterChangeHandler.EffectedMesh) : !IsValid(ParameterChangeHandler.MaterialInstance))
+		return;
+
+	const FMaterialParameterChangeConfig& Config = ParameterChangeHandler.Config;
+	const bool bAnimated = Config.IsAnimation && Config.ParameterType != EMaterialParamType::Texture;
+	bool bWritten = false;
+
+	switch (Config.ParameterType)
 	{
-		float FloatCurveValue;
-		FLinearColor ColorCurveValue;
-		
-		float CurveValueTime = CalculateAnimatedParameterConfigCurveTime(ParameterChangeHandler);
-		
-		switch (ParameterChangeHandler->Config.ParameterType)
+	case EMaterialParamType::Float:
 		{
-		case EMaterialParamType::Float:
-			
-			FloatCurveValue = ParameterChangeHandler->Config.FloatCurve->GetFloatValue(CurveValueTime);
-			
-			if(IsValid(ParameterChangeHandler->MaterialInstance))
+			float Value = Config.FloatParameterValue;
+			if (bAnimated)
 			{
-				ParameterChangeHandler->MaterialInstance->SetScalarParameterValue(
-				ParameterChangeHandler->Config.ParameterName, FMath::Lerp(
-					ParameterChangeHandler->OldFloatValue,
-					ParameterChangeHandler->Config.FloatParameterValue,
-					FloatCurveValue));
+				const float FloatCurveValue = Config.BakedCurve.IsValid()
+					? Config.BakedCurve->SampleFloat(CurveValueTime)
+					: Config.FloatCurve->GetFloatValue(CurveValueTime);
+				Value = FMath::Lerp(ParameterChangeHandler.OldFloatValue, Config.FloatParameterValue, FloatCurveValue);
 			}
-			break;
-			
-		case EMaterialParamType::Color:
-			
-			ColorCurveValue = ParameterChangeHandler->Config.ColorCurve->GetLinearColorValue(CurveValueTime);
-			
-			if(IsValid(ParameterChangeHandler->MaterialInstance))
+
+			bWritten = ParameterChangeHandler.ShouldWrite(FLinearColor(Value, 0, 0, 0));
+			if (bWritten && bUseCustomPrimitiveData)
 			{
-				ParameterChangeHandler->MaterialInstance->SetVectorParameterValue(
-					ParameterChangeHandler->Config.ParameterName, FMath::Lerp(
-						ParameterChangeHandler->OldLinearColorValue,
-						ParameterChangeHandler->Config.LinearColorParameterValue,
-						ColorCurveValue));
+				ParameterChangeHandler.EffectedMesh->SetCustomPrimitiveDataFloat(Config.CustomPrimitiveDataIndex, Value);
+			}
+			else if (bWritten)
+			{
+				ParameterChangeHandler.MaterialInstance->SetScalarParameterValue(Config.ParameterName, Value);
 			}
-			break;
 		}
-	}
-	else
-	{
-		switch (ParameterChangeHandler->Config.ParameterType)
+		break;
+	case EMaterialParamType::Color:
 		{
-		case EMaterialParamType::Float:
-			if(IsValid(ParameterChangeHandler->MaterialInstance))
+			FLinearColor Value = Config.LinearColorParameterValue;
+			if (bAnimated)
 			{
-				ParameterChangeHandler->MaterialInstance->SetScalarParameterValue(
-					ParameterChangeHandler->Config.ParameterName,
-					ParameterChangeHandler->Config.FloatParameterValue);
+				const FLinearColor ColorCurveValue = Config.BakedCurve.IsValid()
+					? Config.BakedCurve->SampleColor(CurveValueTime)
+					: Config.ColorCurve->GetLinearColorValue(CurveValueTime);
+				Value = FMath::Lerp(ParameterChangeHandler.OldLinearColorValue, Config.LinearColorParameterValue, ColorCurveValue);
 			}
-			break;
-		case EMaterialParamType::Color:
-			if(IsValid(ParameterChangeHandler->MaterialInstance))
+
+			bWritten = ParameterChangeHandler.ShouldWrite(Value);
+			if (bWritten && bUseCustomPrimitiveData)
 			{
-				ParameterChangeHandler->MaterialInstance->SetVectorParameterValue(
-					ParameterChangeHandler->Config.ParameterName,
-					ParameterChangeHandler->Config.LinearColorParameterValue);
+				ParameterChangeHandler.EffectedMesh->SetCustomPrimitiveDataVector4(Config.CustomPrimitiveDataIndex, FVector4(Value));
 			}
-			break;
-		case EMaterialParamType::Texture:
-			if(IsValid(ParameterChangeHandler->MaterialInstance))
+			else if (bWritten)
 			{
-				ParameterChangeHandler->MaterialInstance->SetTextureParameterValue(
-					ParameterChangeHandler->Config.ParameterName,
-					ParameterChangeHandler->Config.TextureParameterValue);
+				ParameterChangeHandler.MaterialInstance->SetVectorParameterValue(Config.ParameterName, Value);
 			}
-			break;
 		}
+		break;
+	case EMaterialParamType::Texture:
+		bWritten = ParameterChangeHandler.ShouldWrite(Config.TextureParameterValue.Get());
+		if (bWritten)
+		{
+			ParameterChangeHandler.MaterialInstance->SetTextureParameterValue(Config.ParameterName, Config.TextureParameterValue);
+		}
+		break;
+	}
+
+	/** Every write marks the render proxy dirty, these show how much update traffic the skips save */
+	if (bWritten)
+	{
+		INC_DWORD_STAT(STAT_MatFXParameterWrites);
+	}
+	else
+	{
+		INC_DWORD_STAT(STAT_MatFXSkippedParameterWrites);
 	}
 }
 
-const bool UPVDMaterialEffectControllerComp::SetParametersOfPostProcessMaterials(FMaterialEffectConfig& Config)
+const bool UPVDMaterialEffectControllerComp::SetParametersOfPostProcessMaterials(const FMaterialEffectConfig& Config)
 {
 	if(Config.IsCameraPostProcessMaterial)
 	{
 		const APVDCharacter* Character = Cast<APVDCharacter>(GetOwner());
 		if(Character != nullptr)
 		{
-			for (FMaterialParameterChangeConfig ParameterConfig : Config.ParameterConfigs)
+			for (const FMaterialParameterChangeConfig& ParameterConfig : Config.ParameterConfigs)
 			{
 				for (size_t index = 0; index < Config.EffectedSlotIds.Num(); ++index)
 				{
-					UParameterChangeHandler* ParameterChangeHandler = NewObject<UParameterChangeHandler>();
-					ParameterChangeHandler->Config = ParameterConfig;
-					ParameterChangeHandler->Config = ParameterConfig;
-					ParameterChangeHandler->IsCameraPostProcessMaterial = true;
-					ParameterChangeHandler->SlotId = Config.EffectedSlotIds[index];
-					ParameterChangeHandler->Priority = Config.Priority;
+					const int32 HandlerIndex = AllocateParameterChangeHandler();
+					FParameterChangeHandler& ParameterChangeHandler = ParameterChangeHandlerPool[HandlerIndex];
+					ParameterChangeHandler.Config = ParameterConfig;
+					ParameterChangeHandler.IsCameraPostProcessMaterial = true;
+					ParameterChangeHandler.SlotId = Config.EffectedSlotIds[index];
+					ParameterChangeHandler.Priority = Config.Priority;
 
 					if(!Config.HasLifetime)
 					{
 						GES_MATERIAL_EFFECT_EVENT_CONTEXT(Config.FinisherEventType);
 						
-						TWeakObjectPtr<UParameterChangeHandler> WeakParameterChangeHandler = MakeWeakObjectPtr(ParameterChangeHandler);
-						ParameterChangeHandler->EventContext = GESEventContext;
-						ParameterChangeHandler->LambdaName = FGESHandler::DefaultHandler()->AddLambdaListener(GESEventContext, [WeakParameterChangeHandler]()
+						TWeakObjectPtr<UPVDMaterialEffectControllerComp> WeakThis = MakeWeakObjectPtr(this);
+						const uint32 Generation = ParameterChangeHandler.Generation;
+						ParameterChangeHandler.EventContext = GESEventContext;
+						ParameterChangeHandler.LambdaName = FGESHandler::DefaultHandler()->AddLambdaListener(GESEventContext, [WeakThis, HandlerIndex, Generation]()
 						{
-							if(WeakParameterChangeHandler.IsValid())	
+							if(WeakThis.IsValid())	
 							{
-								WeakParameterChangeHandler->bKillFlag = true;
+								WeakThis->KillParameterChangeHandler(HandlerIndex, Generation);
 							}
 						});
 					}
 					
-					FString KeyName = FString("PostProcess" + (Config.IsOverlaySlot ? "-1" : FString::FromInt(index)));
-			
-					if(!ParameterChangeHandlersMap.Contains(KeyName))
-					{
-						ParameterChangeHandlersMap.Add(KeyName, NewObject<UParameterChangeHandlerArray>());
-					}
-		
-					ParameterChangeHandlersMap[KeyName]->Array.Add(ParameterChangeHandler);
-					
-					ParameterChangeHandlersMap[KeyName]->Array.Sort();
+					ParameterChangeTimings.Start(HandlerIndex, ParameterChangeHandler.Config);
+
+					const uint32 Key = MatFXChannelKey::Make(MatFXChannelKey::PostProcessMeshIndex,
+						Config.IsOverlaySlot ? MatFXChannelKey::OverlaySlotId : static_cast<uint16>(index));
+
+					AddToParameterChangeChannel(Key, HandlerIndex);
 				}
 			}
 		}
@@ -438,65 +829,86 @@ const bool UPVDMaterialEffectControllerComp::SetParametersOfPostProcessMaterials
 	return true;
 }
 
-void UPVDMaterialEffectControllerComp::GarbageCollectionCheckForParameterChanges(TTuple<FString, UParameterChangeHandlerArray*> ParameterChangeHandlers, UParameterChangeHandler* PriorParameterChangeHandler)
+void UPVDMaterialEffectControllerComp::GarbageCollectionCheckForParameterChanges(FParameterChangeChannel& Channel)
 {
-	for(int i = ParameterChangeHandlers.Value->Array.Num() - 1; i >= 0; --i)
+	bool bRestoredOldValues = false;
+
+	for(int i = Channel.Array.Num() - 1; i >= 0; --i)
 	{
-		auto Obj = ParameterChangeHandlers.Value->Array[i];
-		if(Obj->bKillFlag)
+		const int32 HandlerIndex = Channel.Array[i];
+		FParameterChangeHandler& Obj = ParameterChangeHandlerPool[HandlerIndex];
+		if(Obj.bKillFlag || ParameterChangeTimings.IsExpired(HandlerIndex))
 		{
-			if(Obj->ParentConfig == PriorParameterChangeHandler->ParentConfig)
-				Obj->ApplyOldValues();
-			ParameterChangeHandlers.Value->Array.Remove(Obj);
-			FGESHandler::DefaultHandler()->RemoveLambdaListener(Obj->EventContext, Obj->LambdaName);
-			if(PriorParameterChangeHandlerMap[ParameterChangeHandlers.Key] == Obj)
+			if(Obj.ParentConfig == Channel.PriorParentConfig)
 			{
-				PriorParameterChangeHandlerMap.Remove(ParameterChangeHandlers.Key);
+				Obj.ApplyOldValues();
+				bRestoredOldValues = true;
 			}
+			Channel.Array.RemoveAt(i);
+			Channel.bPriorDirty = true;
+			FGESHandler::DefaultHandler()->RemoveLambdaListener(Obj.EventContext, Obj.LambdaName);
+			if(Channel.PriorParameterChangeHandler == HandlerIndex)
+			{
+				Channel.PriorParameterChangeHandler = INDEX_NONE;
+			}
+			ReleaseParameterChangeHandler(HandlerIndex);
 		}
 	}
+
+	/** Surviving handlers may write the same parameters, make them write again over the restored values */
+	if (bRestoredOldValues)
+	{
+		InvalidateParameterChangeChannel(Channel);
+	}
+
+	if (Channel.Array.IsEmpty())
+	{
+		ReturnChannelMaterialInstance(Channel);
+	}
 }
 
 void UPVDMaterialEffectControllerComp::ProcessMaterialsChanges(float DeltaTime)
 {
-	for (int index = 0; index < MaterialChangeHandlers.Num(); ++index)
+	for (const int32 HandlerIndex : MaterialChangeHandlers)
 	{
+		FMaterialChangeHandler& MaterialChangeHandler = MaterialChangeHandlerPool[HandlerIndex];
+
 		//Process delay timer
-		if (MaterialChangeHandlers[index]->Delay > 0 && MaterialChangeHandlers[index]->HasDelay)
+		if (MaterialChangeHandler.Delay > 0 && MaterialChangeHandler.HasDelay)
 		{
-			if (MaterialChangeHandlers[index]->DelayCounter < MaterialChangeHandlers[index]->Delay)
+			if (MaterialChangeHandler.DelayCounter < MaterialChangeHandler.Delay)
 			{
-				MaterialChangeHandlers[index]->DelayCounter += DeltaTime;
+				MaterialChangeHandler.DelayCounter += DeltaTime;
 				continue;
 			}
 		}
 
 		//Apply new material
-		if (!MaterialChangeHandlers[index]->IsApplied)
+		if (!MaterialChangeHandler.IsApplied)
 		{
-			if (MaterialChangeHandlers[index]->IsOverlaySlot)
+			if (MaterialChangeHandler.IsOverlaySlot)
 			{
-				MaterialChangeHandlers[index]->EffectedMesh->SetOverlayMaterial(MaterialChangeHandlers[index]->NewMaterial);
+				MaterialChangeHandler.EffectedMesh->SetOverlayMaterial(MaterialChangeHandler.NewMaterial);
 			}
 			else
 			{
-				MaterialChangeHandlers[index]->EffectedMesh->SetMaterial(MaterialChangeHandlers[index]->SlotId,
-																		MaterialChangeHandlers[index]->NewMaterial);
+				MaterialChangeHandler.EffectedMesh->SetMaterial(MaterialChangeHandler.SlotId,
+															MaterialChangeHandler.NewMaterial);
 			}
 
-			MaterialChangeHandlers[index]->IsApplied = true;
+			MaterialChangeHandler.IsApplied = true;
 		}
 
 		//Check lifetime
-		if (MaterialChangeHandlers[index]->Lifetime > 0 && MaterialChangeHandlers[index]->HasLifetime)
+		if (MaterialChangeHandler.Lifetime > 0 && MaterialChangeHandler.HasLifetime)
 		{
-			if (MaterialChangeHandlers[index]->LifetimeCounter < MaterialChangeHandlers[index]->Lifetime)
+			if (MaterialChangeHandler.LifetimeCounter < MaterialChangeHandler.Lifetime)
 			{
-				MaterialChangeHandlers[index]->LifetimeCounter += DeltaTime;
+				MaterialChangeHandler.LifetimeCounter += DeltaTime;
 			}
-			else if(MaterialChangeHandlers[index]->HasLifetime)
+			else if(MaterialChangeHandler.HasLifetime)
 			{
-				MaterialChangeHandlers[index]->bKillFlag = true;
+				MaterialChangeHandler.bKillFlag = true;
 			}
 		}
 	}
@@ -504,92 +916,180 @@ void UPVDMaterialEffectControllerComp::ProcessMaterialsChanges(float DeltaTime)
 	GarbageCollectionCheckForMaterialChanges();
 }
 
-const bool UPVDMaterialEffectControllerComp::CreateMaterialChangeHandler(FMaterialEffectConfig& Config,
+const bool UPVDMaterialEffectControllerComp::CreateMaterialChangeHandler(const FMaterialEffectConfig& Config,
                                                                 UMaterialInterface* Material,
-                                                                UMeshComponent* MeshComponent)
+                                                                const FMatFXTarget& Target)
 {
-	TArray<FName> SlotNames = MeshComponent->GetMaterialSlotNames();
+	UMeshComponent* MeshComponent = Target.Mesh.Get();
+	if (MeshComponent == nullptr)
+		return false;
 
-	for (size_t index = 0; index < SlotNames.Num(); ++index)
-	{
-		if (!Config.EffectedSlotIds.Contains(index) && !Config.EffectAllSlots && !Config.IsOverlaySlot)
-			continue;
+	if (RetriggerMaterialChangeHandler(Config, MeshComponent, Target.SlotId))
+		return true;
 
-		UMaterialChangeHandler* MaterialChangeHandler = NewObject<UMaterialChangeHandler>();
-		if (Config.HasDelay){
-			MaterialChangeHandler->Delay = Config.Delay;
-			MaterialChangeHandler->HasDelay = Config.HasDelay;
+	const int32 HandlerIndex = AllocateMaterialChangeHandler();
+	FMaterialChangeHandler& MaterialChangeHandler = MaterialChangeHandlerPool[HandlerIndex];
+	if (Config.HasDelay){
+		MaterialChangeHandler.Delay = Config.Delay;
+		MaterialChangeHandler.HasDelay = Config.HasDelay;
         }
-		if (Config.HasLifetime){
-			MaterialChangeHandler->Lifetime = Config.Lifetime;
-			MaterialChangeHandler->HasLifetime = Config.HasLifetime;
+	if (Config.HasLifetime){
+		MaterialChangeHandler.Lifetime = Config.Lifetime;
+		MaterialChangeHandler.HasLifetime = Config.HasLifetime;
         }
-		if(Config.IsOverlaySlot)
-			MaterialChangeHandler->OldMaterial = MeshComponent->GetOverlayMaterial();
-		else
-			MaterialChangeHandler->OldMaterial = MeshComponent->GetMaterial(index);
-			
-		MaterialChangeHandler->NewMaterial = Material;
-		MaterialChangeHandler->EffectedMesh = MeshComponent;
-		MaterialChangeHandler->IsOverlaySlot = Config.IsOverlaySlot;
-		MaterialChangeHandler->SlotId = index;
+	if(Config.IsOverlaySlot)
+		MaterialChangeHandler.OldMaterial = MeshComponent->GetOverlayMaterial();
+	else
+		MaterialChangeHandler.OldMaterial = MeshComponent->GetMaterial(Target.SlotId);
+		
+	MaterialChangeHandler.NewMaterial = Material;
+	MaterialChangeHandler.EffectedMesh = MeshComponent;
+	MaterialChangeHandler.IsOverlaySlot = Config.IsOverlaySlot;
+	MaterialChangeHandler.SlotId = Target.SlotId;
+	MaterialChangeHandler.ParentConfig = &Config;
 
-		if(Config.bHasFinisherEvent)
+	if(Config.bHasFinisherEvent)
+	{
+		GES_MATERIAL_EFFECT_EVENT_CONTEXT(Config.FinisherEventType);
+		TWeakObjectPtr<UPVDMaterialEffectControllerComp> WeakThis = MakeWeakObjectPtr(this);
+		const uint32 Generation = MaterialChangeHandler.Generation;
+		
+		MaterialChangeHandler.EventContext = GESEventContext;
+		MaterialChangeHandler.LambdaName = FGESHandler::DefaultHandler()->AddLambdaListener(GESEventContext, [WeakThis, HandlerIndex, Generation]()
 		{
-			GES_MATERIAL_EFFECT_EVENT_CONTEXT(Config.FinisherEventType);
-			TWeakObjectPtr<UMaterialChangeHandler> WeakMaterialChangeHandler = MakeWeakObjectPtr(MaterialChangeHandler);
-			
-			MaterialChangeHandler->EventContext = GESEventContext;
-			MaterialChangeHandler->LambdaName = FGESHandler::DefaultHandler()->AddLambdaListener(GESEventContext, [WeakMaterialChangeHandler]()
+			if(WeakThis.IsValid())
 			{
-				if(WeakMaterialChangeHandler.IsValid())
-				{
-					WeakMaterialChangeHandler->bKillFlag = true;
-				}
-			});
+				WeakThis->KillMaterialChangeHandler(HandlerIndex, Generation);
+			}
+		});
+	}
+	
+	MaterialChangeHandlers.Add(HandlerIndex);
+	return true;
+}
+
+bool UPVDMaterialEffectControllerComp::RetriggerMaterialChangeHandler(const FMaterialEffectConfig& Config,
+                                                                      const UMeshComponent* MeshComponent,
+                                                                      size_t SlotId)
+{
+	if (Config.RetriggerPolicy == EMatFXRetriggerPolicy::Stack && Config.MaxStack <= 0)
+		return false;
+
+	/** Handlers are kept in creation order, the first one found is the oldest */
+	int32 OldestIndex = INDEX_NONE;
+	int32 NumRunning = 0;
+	for (int32 Index = 0; Index < MaterialChangeHandlers.Num(); ++Index)
+	{
+		const FMaterialChangeHandler& MaterialChangeHandler = MaterialChangeHandlerPool[MaterialChangeHandlers[Index]];
+		if (MaterialChangeHandler.ParentConfig == &Config && MaterialChangeHandler.EffectedMesh == MeshComponent
+			&& MaterialChangeHandler.SlotId == SlotId && !MaterialChangeHandler.bKillFlag)
+		{
+			OldestIndex = NumRunning == 0 ? Index : OldestIndex;
+			++NumRunning;
 		}
-		
-		MaterialChangeHandlers.Add(MaterialChangeHandler);
 	}
+
+	if (NumRunning == 0 || (Config.RetriggerPolicy == EMatFXRetriggerPolicy::Stack && NumRunning < Config.MaxStack))
+		return false;
+
+	const int32 HandlerIndex = MaterialChangeHandlers[OldestIndex];
+	FMaterialChangeHandler& MaterialChangeHandler = MaterialChangeHandlerPool[HandlerIndex];
+
+	switch (Config.RetriggerPolicy)
+	{
+	case EMatFXRetriggerPolicy::Stack:
+	case EMatFXRetriggerPolicy::Restart:
+		/** Once swapped in the material stays, only a delay still pending runs again */
+		if (!MaterialChangeHandler.IsApplied)
+		{
+			MaterialChangeHandler.DelayCounter = 0;
+		}
+		MaterialChangeHandler.LifetimeCounter = 0;
+		MaterialChangeHandlers.RemoveAt(OldestIndex);
+		MaterialChangeHandlers.Add(HandlerIndex);
+		break;
+	case EMatFXRetriggerPolicy::ExtendLifetime:
+		MaterialChangeHandler.LifetimeCounter = 0;
+		break;
+	case EMatFXRetriggerPolicy::IgnoreWhileActive:
+		break;
+	}
+
+	INC_DWORD_STAT(STAT_MatFXCoalescedTriggers);
 	return true;
 }
 
+int32 UPVDMaterialEffectControllerComp::AllocateMaterialChangeHandler()
+{
+	const int32 HandlerIndex = FreeMaterialChangeHandlers.Num() > 0
+		? FreeMaterialChangeHandlers.Pop(false)
+		: MaterialChangeHandlerPool.AddDefaulted();
+
+	MaterialChangeHandlerPool[HandlerIndex].bInUse = true;
+	return HandlerIndex;
+}
+
+void UPVDMaterialEffectControllerComp::ReleaseMaterialChangeHandler(int32 HandlerIndex)
+{
+	FMaterialChangeHandler& MaterialChangeHandler = MaterialChangeHandlerPool[HandlerIndex];
+	const uint32 NextGeneration = MaterialChangeHandler.Generation + 1;
+
+	MaterialChangeHandler = FMaterialChangeHandler();
+	MaterialChangeHandler.Generation = NextGeneration;
+	FreeMaterialChangeHandlers.Add(HandlerIndex);
+}
+
+void UPVDMaterialEffectControllerComp::KillMaterialChangeHandler(int32 HandlerIndex, uint32 Generation)
+{
+	if (!MaterialChangeHandlerPool.IsValidIndex(HandlerIndex))
+		return;
+
+	FMaterialChangeHandler& MaterialChangeHandler = MaterialChangeHandlerPool[HandlerIndex];
+	if (MaterialChangeHandler.bInUse && MaterialChangeHandler.Generation == Generation)
+	{
+		MaterialChangeHandler.bKillFlag = true;
+	}
+}
+
 void UPVDMaterialEffectControllerComp::GarbageCollectionCheckForMaterialChanges()
 {
 	for (int Index = MaterialChangeHandlers.Num() - 1; Index >= 0; --Index)
 	{
-		if(MaterialChangeHandlers[Index]->bKillFlag)
+		const int32 HandlerIndex = MaterialChangeHandlers[Index];
+		FMaterialChangeHandler& MaterialChangeHandler = MaterialChangeHandlerPool[HandlerIndex];
+		if(MaterialChangeHandler.bKillFlag)
 		{
-			if (MaterialChangeHandlers[Index]->OldMaterial)
+			if (MaterialChangeHandler.OldMaterial)
 			{
-				if (MaterialChangeHandlers[Index]->IsOverlaySlot)
+				if (MaterialChangeHandler.IsOverlaySlot)
 				{
-					MaterialChangeHandlers[Index]->EffectedMesh->SetOverlayMaterial(MaterialChangeHandlers[Index]->OldMaterial);
+					MaterialChangeHandler.EffectedMesh->SetOverlayMaterial(MaterialChangeHandler.OldMaterial);
 				}
 				else
 				{
-					MaterialChangeHandlers[Index]->EffectedMesh->SetMaterial(MaterialChangeHandlers[Index]->SlotId,
-																			MaterialChangeHandlers[Index]->OldMaterial);
+					MaterialChangeHandler.EffectedMesh->SetMaterial(MaterialChangeHandler.SlotId,
+																MaterialChangeHandler.OldMaterial);
 				}
 			}
 			
-			FGESHandler::DefaultHandler()->RemoveLambdaListener(MaterialChangeHandlers[Index]->EventContext, MaterialChangeHandlers[Index]->LambdaName);
+			FGESHandler::DefaultHandler()->RemoveLambdaListener(MaterialChangeHandler.EventContext, MaterialChangeHandler.LambdaName);
 			MaterialChangeHandlers.RemoveAt(Index);
+			ReleaseMaterialChangeHandler(HandlerIndex);
 		}
 	}
 }
 
 UMaterialInstanceDynamic* UPVDMaterialEffectControllerComp::CreateDynamicMaterialInstance(
-	UParameterChangeHandler* ParameterChangeHandler)
+	FParameterChangeHandler& ParameterChangeHandler)
 {
 	UMaterialInstanceDynamic* MaterialInstance = nullptr;
 			
-	if (ParameterChangeHandler->IsOverlaySlot)
+	if (ParameterChangeHandler.IsOverlaySlot)
 	{
 		MaterialInstance = Cast<UMaterialInstanceDynamic>(
-			ParameterChangeHandler->EffectedMesh->GetOverlayMaterial());
+			ParameterChangeHandler.EffectedMesh->GetOverlayMaterial());
 	}
-	else if(ParameterChangeHandler->IsCameraPostProcessMaterial)
+	else if(ParameterChangeHandler.IsCameraPostProcessMaterial)
 	{
 		const APVDCharacter* Character = Cast<APVDCharacter>(GetOwner());
 		if(Character != nullptr)
@@ -597,23 +1097,27 @@ UMaterialInstanceDynamic* UPVDMaterialEffectControllerComp::CreateDynamicMateria
 			UCameraComponent* CameraComponent = Character->GetCameraComponent();
 			auto WeightedBlendablesArray = CameraComponent->PostProcessSettings.WeightedBlendables.Array;
 			MaterialInstance = Cast<UMaterialInstanceDynamic>(
-				WeightedBlendablesArray[ParameterChangeHandler->SlotId].Object);
+				WeightedBlendablesArray[ParameterChangeHandler.SlotId].Object);
 		}
 	}
 	else
 	{
 		MaterialInstance = Cast<UMaterialInstanceDynamic>(
-			ParameterChangeHandler->EffectedMesh->GetMaterial(ParameterChangeHandler->SlotId));
+			ParameterChangeHandler.EffectedMesh->GetMaterial(ParameterChangeHandler.SlotId));
+	}
+	if (MaterialInstance == nullptr && bLeaseMaterialInstances && !ParameterChangeHandler.IsCameraPostProcessMaterial)
+	{
+		MaterialInstance = LeaseChannelMaterialInstance(ParameterChangeHandler);
 	}
 	if (MaterialInstance == nullptr)
 	{
-		if (ParameterChangeHandler->IsOverlaySlot)
+		if (ParameterChangeHandler.IsOverlaySlot)
 		{
 			MaterialInstance = UMaterialInstanceDynamic::Create(
-				ParameterChangeHandler->EffectedMesh->GetOverlayMaterial(), this);
-			ParameterChangeHandler->EffectedMesh->SetOverlayMaterial(MaterialInstance);
+				ParameterChangeHandler.EffectedMesh->GetOverlayMaterial(), this);
+			ParameterChangeHandler.EffectedMesh->SetOverlayMaterial(MaterialInstance);
 		}
-		else if (ParameterChangeHandler->IsCameraPostProcessMaterial)
+		else if (ParameterChangeHandler.IsCameraPostProcessMaterial)
 		{
 			const APVDCharacter* Character = Cast<APVDCharacter>(GetOwner());
 			if(Character != nullptr)
@@ -621,22 +1125,226 @@ UMaterialInstanceDynamic* UPVDMaterialEffectControllerComp::CreateDynamicMateria
 				UCameraComponent* CameraComponent = Character->GetCameraComponent();
 				auto WeightedBlendableArray = CameraComponent->PostProcessSettings.WeightedBlendables.Array;
 				MaterialInstance = UMaterialInstanceDynamic::Create(
-					Cast<UMaterialInterface>(WeightedBlendableArray[ParameterChangeHandler->SlotId].Object), this);
-				WeightedBlendableArray[ParameterChangeHandler->SlotId].Object = MaterialInstance;
+					Cast<UMaterialInterface>(WeightedBlendableArray[ParameterChangeHandler.SlotId].Object), this);
+				WeightedBlendableArray[ParameterChangeHandler.SlotId].Object = MaterialInstance;
 				CameraComponent->PostProcessSettings.WeightedBlendables.Array = WeightedBlendableArray;
 			}
 		}
 		else
 		{
 			MaterialInstance = UMaterialInstanceDynamic::Create(
-				ParameterChangeHandler->EffectedMesh->GetMaterial(ParameterChangeHandler->SlotId), this);
-			ParameterChangeHandler->EffectedMesh->SetMaterial(ParameterChangeHandler->SlotId, MaterialInstance);
+				ParameterChangeHandler.EffectedMesh->GetMaterial(ParameterChangeHandler.SlotId), this);
+			ParameterChangeHandler.EffectedMesh->SetMaterial(ParameterChangeHandler.SlotId, MaterialInstance);
+		}
+		OwnedMaterialInstances.Add(MaterialInstance);
+
+		if (UPVDMaterialEffectSubsystem* MaterialEffectSubsystem = MaterialEffectSubsystemPtr.Get())
+		{
+			MaterialEffectSubsystem->NotifyMaterialInstanceCreated();
 		}
 	}
 
 	return MaterialInstance;
 }
 
+float UPVDMaterialEffectControllerComp::GetCurrentScalarValue(const FParameterChangeHandler& ParameterChangeHandler) const
+{
+	if (!ParameterChangeHandler.bUseCustomPrimitiveData)
+	{
+		return ParameterChangeHandler.MaterialInstance->K2_GetScalarParameterValue(ParameterChangeHandler.Config.ParameterName);
+	}
+
+	const UMeshComponent* MeshComponent = ParameterChangeHandler.EffectedMesh;
+	const int32 DataIndex = ParameterChangeHandler.Config.CustomPrimitiveDataIndex;
+	const TArray<float>& Data = MeshComponent->GetCustomPrimitiveData().Data;
+	if (Data.IsValidIndex(DataIndex))
+	{
+		return Data[DataIndex];
+	}
+
+	/** Unset custom primitive data falls back to the parameter default of the material */
+	float Value = 0;
+	const UMaterialInterface* Material = ParameterChangeHandler.IsOverlaySlot
+		? MeshComponent->GetOverlayMaterial()
+		: MeshComponent->GetMaterial(ParameterChangeHandler.SlotId);
+	if (Material != nullptr)
+	{
+		Material->GetScalarParameterValue(FHashedMaterialParameterInfo(ParameterChangeHandler.Config.ParameterName), Value);
+	}
+	return Value;
+}
+
+FLinearColor UPVDMaterialEffectControllerComp::GetCurrentVectorValue(const FParameterChangeHandler& ParameterChangeHandler) const
+{
+	if (!ParameterChangeHandler.bUseCustomPrimitiveData)
+	{
+		return ParameterChangeHandler.MaterialInstance->K2_GetVectorParameterValue(ParameterChangeHandler.Config.ParameterName);
+	}
+
+	const UMeshComponent* MeshComponent = ParameterChangeHandler.EffectedMesh;
+	const int32 DataIndex = ParameterChangeHandler.Config.CustomPrimitiveDataIndex;
+	const TArray<float>& Data = MeshComponent->GetCustomPrimitiveData().Data;
+	if (Data.IsValidIndex(DataIndex + 3))
+	{
+		return FLinearColor(Data[DataIndex], Data[DataIndex + 1], Data[DataIndex + 2], Data[DataIndex + 3]);
+	}
+
+	FLinearColor Value = FLinearColor::Black;
+	const UMaterialInterface* Material = ParameterChangeHandler.IsOverlaySlot
+		? MeshComponent->GetOverlayMaterial()
+		: MeshComponent->GetMaterial(ParameterChangeHandler.SlotId);
+	if (Material != nullptr)
+	{
+		Material->GetVectorParameterValue(FHashedMaterialParameterInfo(ParameterChangeHandler.Config.ParameterName), Value);
+	}
+	return Value;
+}
+
+UMaterialInstanceDynamic* UPVDMaterialEffectControllerComp::LeaseChannelMaterialInstance(
+	FParameterChangeHandler& ParameterChangeHandler)
+{
+	const int32 ChannelIndex = ParameterChangeChannelTable.Find(ParameterChangeHandler.ChannelKey);
+	if (ChannelIndex == INDEX_NONE || !MaterialEffectSubsystemPtr.IsValid())
+		return nullptr;
+
+	UMeshComponent* MeshComponent = ParameterChangeHandler.EffectedMesh;
+	UMaterialInterface* BaseMaterial = ParameterChangeHandler.IsOverlaySlot
+		? MeshComponent->GetOverlayMaterial()
+		: MeshComponent->GetMaterial(ParameterChangeHandler.SlotId);
+	if (BaseMaterial == nullptr)
+		return nullptr;
+
+	FParameterChangeChannel& Channel = ParameterChangeChannels[ChannelIndex];
+	Channel.LeasedMaterialInstance = MaterialEffectSubsystemPtr->LeaseMaterialInstance(BaseMaterial);
+	Channel.LeaseBaseMaterial = BaseMaterial;
+	Channel.bHasLeased = true;
+
+	if (ParameterChangeHandler.IsOverlaySlot)
+	{
+		MeshComponent->SetOverlayMaterial(Channel.LeasedMaterialInstance);
+	}
+	else
+	{
+		MeshComponent->SetMaterial(ParameterChangeHandler.SlotId, Channel.LeasedMaterialInstance);
+	}
+
+	return Channel.LeasedMaterialInstance;
+}
+
+void UPVDMaterialEffectControllerComp::ReturnChannelMaterialInstance(FParameterChangeChannel& Channel)
+{
+	if (Channel.LeasedMaterialInstance == nullptr)
+		return;
+
+	UMaterialInstanceDynamic* MaterialInstance = Channel.LeasedMaterialInstance;
+	UMaterialInterface* BaseMaterial = Channel.LeaseBaseMaterial;
+
+	/** Only put the base material back if no material change replaced the instance meanwhile */
+	const uint16 MeshIndex = MatFXChannelKey::MeshIndexOf(Channel.Key);
+	const uint16 SlotId = MatFXChannelKey::SlotIdOf(Channel.Key);
+	UMeshComponent* MeshComponent = ChannelMeshComponents.IsValidIndex(MeshIndex) ? ChannelMeshComponents[MeshIndex] : nullptr;
+	if (IsValid(MeshComponent))
+	{
+		if (SlotId == MatFXChannelKey::OverlaySlotId)
+		{
+			if (MeshComponent->GetOverlayMaterial() == MaterialInstance)
+			{
+				MeshComponent->SetOverlayMaterial(BaseMaterial);
+			}
+		}
+		else if (MeshComponent->GetMaterial(SlotId) == MaterialInstance)
+		{
+			MeshComponent->SetMaterial(SlotId, BaseMaterial);
+		}
+	}
+
+	/** Material changes still running must not restore an instance another actor may lease next */
+	for (const int32 HandlerIndex : MaterialChangeHandlers)
+	{
+		FMaterialChangeHandler& MaterialChangeHandler = MaterialChangeHandlerPool[HandlerIndex];
+		if (MaterialChangeHandler.OldMaterial == MaterialInstance)
+		{
+			MaterialChangeHandler.OldMaterial = BaseMaterial;
+		}
+	}
+
+	if (MaterialEffectSubsystemPtr.IsValid())
+	{
+		MaterialEffectSubsystemPtr->ReturnMaterialInstance(BaseMaterial, MaterialInstance);
+	}
+
+	Channel.LeasedMaterialInstance = nullptr;
+	Channel.LeaseBaseMaterial = nullptr;
+}
+
+void UPVDMaterialEffectControllerComp::InvalidateTargetCache()
+{
+	if (!CompiledConfigs.IsValid())
+		return;
+
+	for (const FMaterialEffectConfig& Config : CompiledConfigs->Configs)
+	{
+		if (ConfigTargetCache.IsValidIndex(Config.TargetCacheIndex))
+		{
+			ResolveConfigTargets(Config, ConfigTargetCache[Config.TargetCacheIndex]);
+		}
+	}
+}
+
+const TArray<FMatFXTarget>& UPVDMaterialEffectControllerComp::GetConfigTargets(const FMaterialEffectConfig& Config)
+{
+	if (!ensure(ConfigTargetCache.IsValidIndex(Config.TargetCacheIndex)))
+	{
+		ResolveConfigTargets(Config, UncachedConfigTargets);
+		return UncachedConfigTargets.Targets;
+	}
+
+	FMatFXConfigTargets& ConfigTargets = ConfigTargetCache[Config.TargetCacheIndex];
+	if (!ConfigTargets.bResolved)
+	{
+		ResolveConfigTargets(Config, ConfigTargets);
+	}
+	return ConfigTargets.Targets;
+}
+
+void UPVDMaterialEffectControllerComp::ResolveConfigTargets(const FMaterialEffectConfig& Config, FMatFXConfigTargets& OutConfigTargets)
+{
+	OutConfigTargets.Targets.Reset();
+
+	for (UMeshComponent* MeshComponent : GetMeshes(Config))
+	{
+		/** Same rule Run uses to drop stale targets, an unregistered mesh would invalidate the cache on every trigger */
+		if (!MeshComponent->IsRegistered())
+			continue;
+
+		const uint16 MeshIndex = GetChannelMeshIndex(MeshComponent);
+
+		/** Overlay is a single slot whatever the mesh has */
+		if (Config.IsOverlaySlot)
+		{
+			OutConfigTargets.Targets.Add({MeshComponent, 0, MatFXChannelKey::Make(MeshIndex, MatFXChannelKey::OverlaySlotId)});
+			continue;
+		}
+
+		const int32 NumSlots = MeshComponent->GetMaterialSlotNames().Num();
+		for (int32 SlotId = 0; SlotId < NumSlots; ++SlotId)
+		{
+			if (Config.EffectAllSlots || Config.EffectedSlotIds.Contains(SlotId))
+			{
+				OutConfigTargets.Targets.Add({MeshComponent, SlotId, MatFXChannelKey::Make(MeshIndex, static_cast<uint16>(SlotId))});
+			}
+		}
+	}
+
+	OutConfigTargets.bResolved = true;
+}
+
+bool UPVDMaterialEffectControllerComp::HasActiveHandlers() const
+{
+	return MaterialChangeHandlers.Num() > 0
+		|| ParameterChangeHandlerPool.Num() > FreeParameterChangeHandlers.Num();
+}
+
 const TArray<UMeshComponent*> UPVDMaterialEffectControllerComp::GetMeshes(const FMaterialEffectConfig& Config)
 {
 	TArray<UMeshComponent*> MeshComponents;
@@ -647,7 +1355,7 @@ const TArray<UMeshComponent*> UPVDMaterialEffectControllerComp::GetMeshes(const
 		TArray<UMeshComponent*> FilteredMeshComponents;
 		for (UMeshComponent* MeshComponent : MeshComponents)
 		{
-			if (Config.EffectedMeshNameList.Contains(MeshComponent->GetName()) && !Config.ExcludedMeshNameList.Contains(MeshComponent->GetName()))
+			if (Config.EffectedMeshNames.Contains(MeshComponent->GetFName()) && !Config.ExcludedMeshNames.Contains(MeshComponent->GetFName()))
 			{
 				FilteredMeshComponents.Add(MeshComponent);
 			}
@@ -657,7 +1365,7 @@ const TArray<UMeshComponent*> UPVDMaterialEffectControllerComp::GetMeshes(const
 	//else
 	for (int i = MeshComponents.Num()-1; i >= 0; i--)
 	{
-		if (Config.ExcludedMeshNameList.Contains(MeshComponents[i]->GetName()))
+		if (Config.ExcludedMeshNames.Contains(MeshComponents[i]->GetFName()))
 		{
 			MeshComponents.RemoveAt(i);
 		}
@@ -5,6 +5,7 @@
 #include "PVDMaterialEffectControllerComp.generated.h"
 
 class UMaterialEffectConfigDataAsset;
+class UPVDMaterialEffectSubsystem;
 class UCurveFloat;
 class UCurveLinearColor;
 
@@ -66,6 +67,53 @@ enum class EMaterialParamType
 	Texture UMETA(DisplayName="Texture (Can't Animate)")
 };
 
+UENUM()
+enum class EMaterialParamBackend
+{
+	MaterialInstance UMETA(DisplayName="Dynamic Material Instance"),
+	CustomPrimitiveData UMETA(DisplayName="Custom Primitive Data (No MID)")
+};
+
+/** What triggering a config does while it still runs on the same target */
+UENUM()
+enum class EMatFXRetriggerPolicy
+{
+	Stack,
+	Restart,
+	ExtendLifetime,
+	IgnoreWhileActive
+};
+
+/**
+ * Update tier the subsystem gives a controller each tick. Medium updates every few frames, Low updates less often
+ * and jumps animations to their end, so far away or off screen effects only write their final state.
+ */
+enum class EMatFXSignificance : uint8
+{
+	High,
+	Medium,
+	Low
+};
+
+/** Curve sampled at evenly spaced times over [0, 1], both ends included */
+struct FMatFXCurveLUT
+{
+	TArray<float> FloatSamples;
+	TArray<FLinearColor> ColorSamples;
+
+	template<typename T>
+	static FORCEINLINE T Sample(const TArray<T>& Samples, const float Time)
+	{
+		const float Position = FMath::Clamp(Time, 0.0f, 1.0f) * (Samples.Num() - 1);
+		const int32 Index = FMath::Min(FMath::FloorToInt(Position), Samples.Num() - 2);
+		return FMath::Lerp(Samples[Index], Samples[Index + 1], Position - Index);
+	}
+
+	float SampleFloat(const float Time) const { return Sample(FloatSamples, Time); }
+
+	FLinearColor SampleColor(const float Time) const { return Sample(ColorSamples, Time); }
+};
+
 USTRUCT()
 struct FMaterialParameterChangeConfig
 {
@@ -73,6 +121,14 @@ struct FMaterialParameterChangeConfig
 
 	UPROPERTY(EditAnywhere)
 	FName ParameterName;
+
+	/** Custom primitive data keeps draws batched and needs no MID, the material parameter must read that index */
+	UPROPERTY(EditAnywhere, meta = (EditConditionHides, EditCondition = "ParameterType != EMaterialParamType::Texture"))
+	EMaterialParamBackend Backend = EMaterialParamBackend::MaterialInstance;
+
+	/** First custom primitive data float, colors use four */
+	UPROPERTY(EditAnywhere, meta = (ClampMin = "0", EditConditionHides, EditCondition = "Backend == EMaterialParamBackend::CustomPrimitiveData && ParameterType != EMaterialParamType::Texture"))
+	int32 CustomPrimitiveDataIndex = 0;
 	
 	UPROPERTY(EditAnywhere, meta = (EditConditionHides, EditCondition = "ParameterType != EMaterialParamType::Texture"))
 	EMaterialParameterChangeType ParameterChangeType;
@@ -85,6 +141,13 @@ struct FMaterialParameterChangeConfig
 	
 	UPROPERTY(EditAnywhere, meta = (EditConditionHides, EditCondition = "IsAnimation && ParameterType != EMaterialParamType::Texture"))
 	bool bLoopAnimation;
+
+	/**
+	 * Curve samples baked at BeginPlay, zero evaluates the curve asset every tick. Curves with constant keys, or
+	 * that the samples cannot follow within MatFXCurveBakeTolerance, are never baked and always evaluate the asset.
+	 */
+	UPROPERTY(EditAnywhere, meta = (ClampMin = "0", EditConditionHides, EditCondition = "IsAnimation && ParameterType != EMaterialParamType::Texture"))
+	int32 CurveBakeResolution = 64;
 	
 	UPROPERTY(EditAnywhere, meta = (EditConditionHides, EditCondition = "ParameterType == EMaterialParamType::Float"))
 	bool ReturnToDefaultValue;
@@ -132,6 +195,17 @@ struct FMaterialParameterChangeConfig
 			"!IsAnimation && ParameterType == EMaterialParamType::Texture"
 		))
 	TObjectPtr<UTexture2D> TextureParameterValue;
+
+	/** Runtime only, shared by every copy of the config */
+	TSharedPtr<const FMatFXCurveLUT> BakedCurve;
+
+	/** Textures cannot go through custom primitive data and always use a MID */
+	bool UsesCustomPrimitiveData() const
+	{
+		return Backend == EMaterialParamBackend::CustomPrimitiveData && ParameterType != EMaterialParamType::Texture;
+	}
+
+	void BakeCurve();
 };
 
 USTRUCT()
@@ -165,6 +239,11 @@ struct FMaterialEffectConfig
 	bool EffectAllSlots;
 	UPROPERTY(EditAnywhere, meta = (EditConditionHides, EditCondition = "!EffectAllSlots && !IsOverlaySlot"))
 	TArray<int> EffectedSlotIds;
+	UPROPERTY(EditAnywhere)
+	EMatFXRetriggerPolicy RetriggerPolicy = EMatFXRetriggerPolicy::Stack;
+	/** Running instances per target before a trigger restarts the oldest one instead, zero stacks without limit */
+	UPROPERTY(EditAnywhere, meta = (ClampMin = "0", EditConditionHides, EditCondition = "RetriggerPolicy == EMatFXRetriggerPolicy::Stack"))
+	int32 MaxStack = 0;
 	UPROPERTY(EditAnywhere,
 		meta = (EditConditionHides, EditCondition = "MaterialEffectType == EMaterialEffectType::ChangeParameters"))
 	TArray<FMaterialParameterChangeConfig> ParameterConfigs;
@@ -176,25 +255,54 @@ struct FMaterialEffectConfig
 	bool HasLifetime;
 	UPROPERTY(EditAnywhere, meta = (EditConditionHides, EditCondition = "hasLifetime && MaterialEffectType != EMaterialEffectType::ChangeParameters"))
 	float Lifetime;
+
+	/** Runtime only, index in the compiled configs and in the owning controller's target cache */
+	int32 TargetCacheIndex = INDEX_NONE;
+
+	/** Runtime only, mesh name lists interned when compiled, the string lists are emptied then */
+	TArray<FName> EffectedMeshNames;
+	TArray<FName> ExcludedMeshNames;
 };
 
-USTRUCT()
-struct FMaterialEffectConfigContainer
+/** Range of one event's configs in the compiled config table */
+struct FMatFXEventConfigRange
 {
-	GENERATED_BODY()
+	int32 Start = 0;
+	int32 Num = 0;
+};
 
+/**
+ * Read only runtime form of a controller's configs, grouped by event with interned mesh names and baked curves.
+ * Controllers using the same data assets share one instance. UObjects it references are kept alive by the source
+ * data assets or inline configs, which every controller sharing it holds.
+ */
+struct FMatFXCompiledConfigs
+{
 	TArray<FMaterialEffectConfig> Configs;
+
+	/** Indexed by EMatFXGlobalEvent */
+	TArray<FMatFXEventConfigRange> EventConfigRanges;
+
+	void Build(const TArray<const FMaterialEffectConfig*>& SourceConfigs);
+
+	/** Sum of allocated bytes, for comparing shared and per actor configs */
+	SIZE_T GetAllocatedSize() const;
 };
 
-UCLASS()
-class UMaterialChangeHandler : public UObject
+/**
+ * Handlers are plain structs living in pools owned by the controller component and recycled through a free list.
+ * Only the UObject references the GC has to see are UPROPERTYs, so triggering an effect allocates no UObject.
+ * Generation changes every time a slot is reused, finisher event listeners use it to ignore recycled slots.
+ */
+USTRUCT()
+struct FMaterialChangeHandler
 {
 	GENERATED_BODY()
-public:
+
 	UPROPERTY()
 	TObjectPtr<UMeshComponent> EffectedMesh;
 	bool IsOverlaySlot = false;
-	size_t SlotId;
+	size_t SlotId = 0;
 	UPROPERTY()
 	TObjectPtr<UMaterialInterface> OldMaterial;
 	UPROPERTY()
@@ -203,43 +311,92 @@ public:
 	bool bKillFlag = false;
 	float Delay = 0;
 	float DelayCounter = 0;
-	bool HasDelay;
+	bool HasDelay = false;
 	float Lifetime = 0;
 	float LifetimeCounter = 0;
-	bool HasLifetime;
+	bool HasLifetime = false;
 	FString LambdaName;
 	FGESEventContext EventContext;
+	const FMaterialEffectConfig* ParentConfig = nullptr;
+
+	bool bInUse = false;
+	uint32 Generation = 0;
 };
 
-UCLASS()
-class UParameterChangeHandler : public UObject
+USTRUCT()
+struct FParameterChangeHandler
 {
 	GENERATED_BODY()
-public:
+
 	UPROPERTY()
 	TObjectPtr<UMeshComponent> EffectedMesh;
 	UPROPERTY()
 	TObjectPtr<UMaterialInstanceDynamic> MaterialInstance;
 	bool IsOverlaySlot = false;
 	bool IsCameraPostProcessMaterial = false;
-	size_t SlotId;
-	float OldFloatValue;
+	bool bUseCustomPrimitiveData = false;
+	bool bIsSetUp = false;
+	size_t SlotId = 0;
+	uint32 ChannelKey = 0;
+	float OldFloatValue = 0;
 	FLinearColor OldLinearColorValue;
 	UPROPERTY()
 	TObjectPtr<UTexture> OldTextureValue;
+	UPROPERTY()
 	FMaterialParameterChangeConfig Config;
-	FMaterialEffectConfig* ParentConfig;
+	const FMaterialEffectConfig* ParentConfig = nullptr;
+	/** Index in ParentConfig's parameter configs, retriggers of the config find the handler with it */
+	int32 ParameterIndex = INDEX_NONE;
+	/** Set on start and restart, the lowest serial of a config's running handlers is its oldest */
+	uint32 TriggerSerial = 0;
 	bool IsApplied = false;
 	bool bKillFlag = false;
-	float DelayCounter = 0;
-	float LifetimeCounter = 0;
-	float AnimationCounter = 0;
 	FString LambdaName;
 	FGESEventContext EventContext;
-	int Priority;
+	int Priority = 0;
+
+	bool bInUse = false;
+	uint32 Generation = 0;
+
+	/** Last value written to MaterialInstance, floats use the red channel */
+	FLinearColor LastWrittenValue;
+	const UTexture* LastWrittenTexture = nullptr;
+	bool bHasWrittenValue = false;
+
+	/** False when the material instance already holds this value */
+	bool ShouldWrite(const FLinearColor& Value)
+	{
+		if (bHasWrittenValue && LastWrittenValue == Value)
+			return false;
+		LastWrittenValue = Value;
+		bHasWrittenValue = true;
+		return true;
+	}
+
+	bool ShouldWrite(const UTexture* Texture)
+	{
+		if (bHasWrittenValue && LastWrittenTexture == Texture)
+			return false;
+		LastWrittenTexture = Texture;
+		bHasWrittenValue = true;
+		return true;
+	}
 
 	void ApplyOldValues()
 	{
+		/** Old values are only captured by the initial setup */
+		if (!bIsSetUp)
+			return;
+
+		if (bUseCustomPrimitiveData)
+		{
+			if (IsValid(EffectedMesh))
+			{
+				SetCustomPrimitiveData(OldLinearColorValue, OldFloatValue);
+			}
+			return;
+		}
+
 		switch (Config.ParameterType)
 		{
 		case EMaterialParamType::Float:
@@ -268,31 +425,275 @@ public:
 			break;
 		}
 	}
+
+	void SetCustomPrimitiveData(const FLinearColor& ColorValue, const float FloatValue) const
+	{
+		if (Config.ParameterType == EMaterialParamType::Color)
+		{
+			EffectedMesh->SetCustomPrimitiveDataVector4(Config.CustomPrimitiveDataIndex, FVector4(ColorValue));
+		}
+		else
+		{
+			EffectedMesh->SetCustomPrimitiveDataFloat(Config.CustomPrimitiveDataIndex, FloatValue);
+		}
+	}
 };
 
-template <>
-struct TLess<UParameterChangeHandler>
+/** Parameter channel key, packs the index of the mesh component in the controller and the material slot */
+namespace MatFXChannelKey
 {
-	FORCEINLINE bool operator()(const UParameterChangeHandler& A,const UParameterChangeHandler& B) const
+	constexpr uint16 PostProcessMeshIndex = MAX_uint16;
+	constexpr uint16 OverlaySlotId = MAX_uint16;
+
+	/** Custom primitive data belongs to the primitive, not a slot, its channels use ids no material slot reaches */
+	constexpr uint16 CustomPrimitiveDataSlotBase = 0x8000;
+
+	FORCEINLINE uint16 CustomPrimitiveDataSlotId(const int32 CustomPrimitiveDataIndex)
 	{
-		return A.Priority > B.Priority;
+		return static_cast<uint16>(CustomPrimitiveDataSlotBase | (CustomPrimitiveDataIndex & 0x7FFF));
 	}
-};
 
-UCLASS()
-class UParameterChangeHandlerArray : public UObject
+	FORCEINLINE uint32 Make(const uint16 MeshIndex, const uint16 SlotId)
+	{
+		return (static_cast<uint32>(MeshIndex) << 16) | SlotId;
+	}
+
+	FORCEINLINE uint16 MeshIndexOf(const uint32 Key)
+	{
+		return static_cast<uint16>(Key >> 16);
+	}
+
+	FORCEINLINE uint16 SlotIdOf(const uint32 Key)
+	{
+		return static_cast<uint16>(Key & MAX_uint16);
+	}
+}
+
+/**
+ * Handlers competing for one (mesh, slot) channel, indices into the handler pool kept sorted by priority on insert.
+ * The prior handler is only resolved again when a handler joins or leaves the channel.
+ */
+USTRUCT()
+struct FParameterChangeChannel
 {
 	GENERATED_BODY()
-public:
+
+	TArray<int32> Array;
+
+	int32 PriorParameterChangeHandler = INDEX_NONE;
+
+	const FMaterialEffectConfig* PriorParentConfig = nullptr;
+
+	bool bPriorDirty = false;
+
+	/** Material instance leased from UPVDMaterialEffectSubsystem while the channel has handlers */
 	UPROPERTY()
-	TArray<UParameterChangeHandler*> Array;
+	TObjectPtr<UMaterialInstanceDynamic> LeasedMaterialInstance;
+
+	UPROPERTY()
+	TObjectPtr<UMaterialInterface> LeaseBaseMaterial;
+
+	/** Whether this channel ever needed a material instance, for the memory report */
+	bool bHasLeased = false;
+
+	uint32 Key = 0;
 };
 
+/** Per handler bits of FParameterChangeTimings::Flags */
+namespace MatFXTimingFlags
+{
+	constexpr uint8 Active = 1 << 0;
+	constexpr uint8 Animation = 1 << 1;
+	constexpr uint8 Loop = 1 << 2;
+	constexpr uint8 Prior = 1 << 3;
+	constexpr uint8 Expired = 1 << 4;
+}
+
+/**
+ * Timing state of the parameter change handlers as structure of arrays, indexed like the handler pool.
+ * Missing delay is stored as zero and missing lifetime as MAX_flt so Advance runs without per handler branches.
+ */
+struct FParameterChangeTimings
+{
+	TArray<float> Delay;
+	TArray<float> DelayCounter;
+	TArray<float> Lifetime;
+	TArray<float> LifetimeCounter;
+	TArray<float> AnimationCounter;
+	TArray<float> InvAnimationTime;
+	TArray<float> CurveTime;
+	TArray<float> LastCurveTime;
+	TArray<uint8> Flags;
+	TArray<uint8> Changed;
+
+	void AddDefaulted()
+	{
+		Delay.Add(0);
+		DelayCounter.Add(0);
+		Lifetime.Add(MAX_flt);
+		LifetimeCounter.Add(0);
+		AnimationCounter.Add(0);
+		InvAnimationTime.Add(0);
+		CurveTime.Add(0);
+		LastCurveTime.Add(-1);
+		Flags.Add(0);
+		Changed.Add(0);
+	}
+
+	void Start(int32 Index, const FMaterialParameterChangeConfig& Config);
+
+	/** Runs the handler again from its delay, keeps whether it is prior */
+	void Restart(const int32 Index, const FMaterialParameterChangeConfig& Config)
+	{
+		const uint8 PriorFlag = Flags[Index] & MatFXTimingFlags::Prior;
+		Start(Index, Config);
+		Flags[Index] |= PriorFlag;
+	}
+
+	void ExtendLifetime(const int32 Index)
+	{
+		LifetimeCounter[Index] = 0;
+	}
+
+	void Stop(const int32 Index)
+	{
+		Flags[Index] = 0;
+	}
+
+	/** Forces the next Advance to report the handler as changed, used when it becomes the prior one again */
+	void Invalidate(const int32 Index)
+	{
+		LastCurveTime[Index] = -1;
+	}
+
+	/** Returns true when the handler just became prior and was invalidated */
+	bool SetPrior(const int32 Index, const bool bPrior)
+	{
+		const bool bBecamePrior = bPrior && (Flags[Index] & MatFXTimingFlags::Prior) == 0;
+		if (bBecamePrior)
+		{
+			Invalidate(Index);
+		}
+		Flags[Index] = static_cast<uint8>(bPrior ? (Flags[Index] | MatFXTimingFlags::Prior) : (Flags[Index] & ~MatFXTimingFlags::Prior));
+		return bBecamePrior;
+	}
+
+	bool IsExpired(const int32 Index) const
+	{
+		return (Flags[Index] & MatFXTimingFlags::Expired) != 0;
+	}
+
+	/**
+	 * Advances every active handler and collects the prior ones whose output changed. Skipping animation keeps
+	 * the counters running but samples non looping curves at their end and holds looping ones.
+	 */
+	void Advance(float DeltaTime, bool bSkipAnimation, TArray<int32>& OutChangedHandlers);
+};
+
+/**
+ * Flat open addressing table from channel key to channel index, linear probing on a power of two bucket count.
+ * Channels are never removed once created, so no tombstones are needed.
+ */
+struct FMatFXChannelTable
+{
+	int32 Find(const uint32 Key) const
+	{
+		if (Num == 0)
+		{
+			return INDEX_NONE;
+		}
+
+		for (uint32 Bucket = Hash(Key);; Bucket = (Bucket + 1) & Mask())
+		{
+			if (Values[Bucket] == INDEX_NONE)
+			{
+				return INDEX_NONE;
+			}
+			if (Keys[Bucket] == Key)
+			{
+				return Values[Bucket];
+			}
+		}
+	}
+
+	void Add(const uint32 Key, const int32 Value)
+	{
+		if ((Num + 1) * 4 > Keys.Num() * 3)
+		{
+			Grow();
+		}
+		Insert(Key, Value);
+		++Num;
+	}
+
+private:
+	TArray<uint32> Keys;
+	TArray<int32> Values;
+	int32 Num = 0;
+
+	uint32 Mask() const
+	{
+		return static_cast<uint32>(Keys.Num() - 1);
+	}
+
+	uint32 Hash(const uint32 Key) const
+	{
+		return (Key * 2654435761u >> 7) & Mask();
+	}
+
+	void Insert(const uint32 Key, const int32 Value)
+	{
+		uint32 Bucket = Hash(Key);
+		while (Values[Bucket] != INDEX_NONE)
+		{
+			Bucket = (Bucket + 1) & Mask();
+		}
+		Keys[Bucket] = Key;
+		Values[Bucket] = Value;
+	}
+
+	void Grow()
+	{
+		TArray<uint32> OldKeys = MoveTemp(Keys);
+		TArray<int32> OldValues = MoveTemp(Values);
+
+		const int32 NewSize = FMath::Max(16, OldKeys.Num() * 2);
+		Keys.SetNumZeroed(NewSize);
+		Values.Init(INDEX_NONE, NewSize);
+
+		for (int32 Index = 0; Index < OldKeys.Num(); ++Index)
+		{
+			if (OldValues[Index] != INDEX_NONE)
+			{
+				Insert(OldKeys[Index], OldValues[Index]);
+			}
+		}
+	}
+};
+
+/** Mesh and material slot a config effects, with the parameter channel key of that slot. Targets of one mesh are contiguous */
+struct FMatFXTarget
+{
+	TWeakObjectPtr<UMeshComponent> Mesh;
+	int32 SlotId = 0;
+	uint32 ChannelKey = 0;
+};
+
+/** Targets of one config, resolved at BeginPlay and again when the cache is invalidated */
+struct FMatFXConfigTargets
+{
+	TArray<FMatFXTarget> Targets;
+	bool bResolved = false;
+};
+
+/** Does not tick on its own, UPVDMaterialEffectSubsystem processes it while it has running handlers */
 UCLASS(ClassGroup=(Custom), meta=(BlueprintSpawnableComponent))
 class PVD_API UPVDMaterialEffectControllerComp : public UActorComponent
 {
 	GENERATED_BODY()
 
+	friend class UPVDMaterialEffectSubsystem;
+
 public:
 	UPVDMaterialEffectControllerComp();
 
@@ -300,22 +701,55 @@ protected:
 	virtual void BeginPlay() override;
 	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 
-public:
-	virtual void TickComponent(float DeltaTime, ELevelTick TickType,
-	                           FActorComponentTickFunction* ThisTickFunction) override;
-
 private:
-	UPROPERTY()
-	TMap<EMatFXGlobalEvent, FMaterialEffectConfigContainer> EventConfigMap;
+	TWeakObjectPtr<UPVDMaterialEffectSubsystem> MaterialEffectSubsystemPtr;
+
+	/** Whether the subsystem has this controller in its tick batch, owned by the subsystem */
+	bool bMaterialEffectsActive = false;
+
+	/** Owned by the subsystem, frames a lower tier skips add up here until the controller updates */
+	EMatFXSignificance Significance = EMatFXSignificance::High;
+	float PendingDeltaTime = 0.0f;
+
+	/** Shared with other controllers using the same data assets, handlers point into it */
+	TSharedPtr<const FMatFXCompiledConfigs> CompiledConfigs;
 	
+	/** Active material change handlers in creation order, indices into MaterialChangeHandlerPool */
+	TArray<int32> MaterialChangeHandlers;
+
 	UPROPERTY()
-	TArray<UMaterialChangeHandler*> MaterialChangeHandlers;
+	TArray<FMaterialChangeHandler> MaterialChangeHandlerPool;
+
+	TArray<int32> FreeMaterialChangeHandlers;
 
 	UPROPERTY()
-	TMap<FString, UParameterChangeHandlerArray*> ParameterChangeHandlersMap;
+	TArray<FParameterChangeHandler> ParameterChangeHandlerPool;
+
+	TArray<int32> FreeParameterChangeHandlers;
+
+	FParameterChangeTimings ParameterChangeTimings;
+
+	uint32 NextParameterTriggerSerial = 0;
+
+	/** Handlers to write this tick, filled by FParameterChangeTimings::Advance */
+	TArray<int32> PendingParameterWrites;
+
+	UPROPERTY()
+	TArray<FParameterChangeChannel> ParameterChangeChannels;
+
+	FMatFXChannelTable ParameterChangeChannelTable;
+
+	/** Resolved targets per config, indexed by FMaterialEffectConfig::TargetCacheIndex */
+	TArray<FMatFXConfigTargets> ConfigTargetCache;
+
+	FMatFXConfigTargets UncachedConfigTargets;
+
+	/** Instances created for this actor when not leasing, kept for the memory report */
+	TArray<TWeakObjectPtr<UMaterialInstanceDynamic>> OwnedMaterialInstances;
 
+	/** Meshes that own a parameter channel, their index is the mesh part of the channel key */
 	UPROPERTY()
-	TMap<FString, UParameterChangeHandler*> PriorParameterChangeHandlerMap;
+	TArray<TObjectPtr<UMeshComponent>> ChannelMeshComponents;
 
 public:
 	UPROPERTY(EditAnywhere)
@@ -327,6 +761,35 @@ public:
 	UPROPERTY(BlueprintAssignable)
 	FConfigRunnedWithGES OnConfigRunnedWithGES;
 
+	/**
+	 * Idle meshes keep their base materials and effects lease material instances from a pool shared with other
+	 * actors, returned when the effect ends. Off, every effected slot keeps its own instance for the actor lifetime.
+	 */
+	UPROPERTY(EditAnywhere)
+	bool bLeaseMaterialInstances = false;
+
+	/**
+	 * Distant or off screen actors update their effects less often and skip animations to the final state.
+	 * Pawns and view targets of local players always update every frame.
+	 */
+	UPROPERTY(EditAnywhere)
+	bool bUseSignificance = true;
+
+	/**
+	 * Resolves config targets again, call after adding or registering a mesh component on the owner or giving one
+	 * a mesh with other material slots. Destroyed and unregistered meshes are dropped on the first trigger that reaches them.
+	 */
+	UFUNCTION(BlueprintCallable)
+	void InvalidateTargetCache();
+
+	/** Parameter handlers in use, running or waiting for their channel */
+	int32 GetNumParameterChangeHandlers() const
+	{
+		return ParameterChangeHandlerPool.Num() - FreeParameterChangeHandlers.Num();
+	}
+
+	int32 GetNumMaterialChangeHandlers() const { return MaterialChangeHandlers.Num(); }
+
 private:
 	UFUNCTION()
 	void CategorizeConfigsWithEvents();
@@ -334,34 +797,49 @@ private:
 	UFUNCTION(BlueprintCallable)
 	void RunConfigWithParameter(EMatFXGlobalEvent Type);
 
-	UFUNCTION()
-	void Run(TArray<FMaterialEffectConfig> ConfigArray);
+	void RunEvent(EMatFXGlobalEvent Type);
 	
-	void Run(FMaterialEffectConfig& Config);
+	void Run(const FMaterialEffectConfig& Config);
 
 	//Parameter Change Functions
 	
-	UFUNCTION()
-	void ProcessParameterChanges(float DeltaTime);
-	
-	UFUNCTION()
-	const bool CreateParameterChangeHandler(FMaterialEffectConfig& Config, UMeshComponent* MeshComponent);
+	void PrepareParameterChanges();
+
+	/** Only touches FParameterChangeTimings, safe to run off the game thread */
+	void AdvanceParameterChangeTimings(float DeltaTime);
+
+	void ApplyParameterChanges();
 	
-	UFUNCTION()
-	void InitialSetupParameterChangeHandler(UParameterChangeHandler* ParameterChangeHandler);
+	/** Custom primitive data parameters are per mesh, they are only created for the first target of each mesh */
+	const bool CreateParameterChangeHandler(const FMaterialEffectConfig& Config, const FMatFXTarget& Target,
+	                                        bool bFirstTargetOfMesh);
 
-	UParameterChangeHandler* EvaluatePriorParameterChangeHandler(TTuple<FString, UParameterChangeHandlerArray*> ParameterChangeHandlers);
+	/** Applies the config's retrigger policy to its running handlers, false when a new handler is needed */
+	bool RetriggerParameterChangeHandler(const FMaterialEffectConfig& Config, int32 ParameterIndex, uint32 ChannelKey);
 	
-	UFUNCTION()
-	float CalculateAnimatedParameterConfigCurveTime(UParameterChangeHandler* ParameterChangeHandler);
+	int32 AllocateParameterChangeHandler();
+
+	void ReleaseParameterChangeHandler(int32 HandlerIndex);
+
+	void KillParameterChangeHandler(int32 HandlerIndex, uint32 Generation);
+
+	void InitialSetupParameterChangeHandler(FParameterChangeHandler& ParameterChangeHandler);
+
+	FParameterChangeChannel& FindOrAddParameterChangeChannel(uint32 Key);
+
+	uint16 GetChannelMeshIndex(UMeshComponent* MeshComponent);
+
+	void AddToParameterChangeChannel(uint32 Key, int32 HandlerIndex);
+
+	void EvaluatePriorParameterChangeHandler(FParameterChangeChannel& Channel);
+
+	void InvalidateParameterChangeChannel(const FParameterChangeChannel& Channel);
 	
-	UFUNCTION()
-	void ApplyParameterChange(UParameterChangeHandler* ParameterChangeHandler);
+	void ApplyParameterChange(FParameterChangeHandler& ParameterChangeHandler, float CurveValueTime);
 	
-	UFUNCTION()
-	const bool SetParametersOfPostProcessMaterials(FMaterialEffectConfig& Config);
+	const bool SetParametersOfPostProcessMaterials(const FMaterialEffectConfig& Config);
 
-	void GarbageCollectionCheckForParameterChanges(TTuple<FString, UParameterChangeHandlerArray*> ParameterChangeHandlers, UParameterChangeHandler* PriorParameterChangeHandler);
+	void GarbageCollectionCheckForParameterChanges(FParameterChangeChannel& Channel);
 	
 	//End of Parameter Change Functions
 
@@ -370,9 +848,17 @@ private:
 	UFUNCTION()
 	void ProcessMaterialsChanges(float DeltaTime);
 	
-	UFUNCTION()
-	const bool CreateMaterialChangeHandler(FMaterialEffectConfig& Config, UMaterialInterface* Material,
-								  UMeshComponent* MeshComponent);
+	const bool CreateMaterialChangeHandler(const FMaterialEffectConfig& Config, UMaterialInterface* Material,
+								  const FMatFXTarget& Target);
+
+	bool RetriggerMaterialChangeHandler(const FMaterialEffectConfig& Config, const UMeshComponent* MeshComponent,
+	                                    size_t SlotId);
+
+	int32 AllocateMaterialChangeHandler();
+
+	void ReleaseMaterialChangeHandler(int32 HandlerIndex);
+
+	void KillMaterialChangeHandler(int32 HandlerIndex, uint32 Generation);
 	
 	UFUNCTION()
 	void GarbageCollectionCheckForMaterialChanges();
@@ -380,9 +866,24 @@ private:
 	//End of Material Change Functions
 
 	//Common Utility Functions
+
+	bool HasActiveHandlers() const;
+
+	const TArray<FMatFXTarget>& GetConfigTargets(const FMaterialEffectConfig& Config);
+
+	void ResolveConfigTargets(const FMaterialEffectConfig& Config, FMatFXConfigTargets& OutConfigTargets);
+
 	
-	UFUNCTION()
-	UMaterialInstanceDynamic* CreateDynamicMaterialInstance(UParameterChangeHandler* ParameterChangeHandler);
+	UMaterialInstanceDynamic* CreateDynamicMaterialInstance(FParameterChangeHandler& ParameterChangeHandler);
+
+	/** Value the parameter has before the handler changes it, from the MID or the primitive */
+	float GetCurrentScalarValue(const FParameterChangeHandler& ParameterChangeHandler) const;
+
+	FLinearColor GetCurrentVectorValue(const FParameterChangeHandler& ParameterChangeHandler) const;
+
+	UMaterialInstanceDynamic* LeaseChannelMaterialInstance(FParameterChangeHandler& ParameterChangeHandler);
+
+	void ReturnChannelMaterialInstance(FParameterChangeChannel& Channel);
 	
 	UFUNCTION()
 	const TArray<UMeshComponent*> GetMeshes(const FMaterialEffectConfig& Config);
@@ -0,0 +1,614 @@
+#include "PVDMaterialEffectSubsystem.h"
+#include "PVDMaterialEffectControllerComp.h"
+#include "GESHandler.h"
+#include "Async/ParallelFor.h"
+#include "Misc/App.h"
+#include "GameFramework/PlayerController.h"
+#include "Materials/MaterialInstanceDynamic.h"
+#include "PVD/Data/MaterialEffectConfigDataAsset.h"
+#include "ProfilingDebugging/CsvProfiler.h"
+
+DECLARE_CYCLE_STAT(TEXT("Prepare Parameter Changes"), STAT_MatFXPrepareParameterChanges, STATGROUP_MatFX);
+DECLARE_CYCLE_STAT(TEXT("Advance Parameter Timings"), STAT_MatFXAdvanceParameterTimings, STATGROUP_MatFX);
+DECLARE_CYCLE_STAT(TEXT("Apply Parameter Changes"), STAT_MatFXApplyParameterChanges, STATGROUP_MatFX);
+DECLARE_CYCLE_STAT(TEXT("Process Materials Changes"), STAT_MatFXProcessMaterialsChanges, STATGROUP_MatFX);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Active Controllers"), STAT_MatFXActiveControllers, STATGROUP_MatFX);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Parameter Handlers"), STAT_MatFXParameterHandlers, STATGROUP_MatFX);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Material Handlers"), STAT_MatFXMaterialHandlers, STATGROUP_MatFX);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Material Instances Created"), STAT_MatFXMaterialInstancesCreated, STATGROUP_MatFX);
+DECLARE_DWORD_COUNTER_STAT(TEXT("High Significance Controllers"), STAT_MatFXHighSignificanceControllers, STATGROUP_MatFX);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Medium Significance Controllers"), STAT_MatFXMediumSignificanceControllers, STATGROUP_MatFX);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Low Significance Controllers"), STAT_MatFXLowSignificanceControllers, STATGROUP_MatFX);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Skipped Controller Updates"), STAT_MatFXSkippedControllerUpdates, STATGROUP_MatFX);
+DECLARE_DWORD_COUNTER_STAT(TEXT("High Significance Writes"), STAT_MatFXHighSignificanceWrites, STATGROUP_MatFX);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Medium Significance Writes"), STAT_MatFXMediumSignificanceWrites, STATGROUP_MatFX);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Low Significance Writes"), STAT_MatFXLowSignificanceWrites, STATGROUP_MatFX);
+
+/** CSV category so -csvCaptureFrames picks the batch tick up in headless runs without the stats system */
+CSV_DEFINE_CATEGORY(MatFX, true);
+
+/** Below this many active controllers the timing pass is cheaper than waking worker threads */
+static constexpr int32 MatFXParallelTimingThreshold = 16;
+
+static TAutoConsoleVariable<float> CVarMatFXMediumSignificanceDistance(
+	TEXT("MatFX.Significance.MediumDistance"), 2500.0f,
+	TEXT("Distance from the view beyond which material effects update at medium significance"));
+
+static TAutoConsoleVariable<float> CVarMatFXLowSignificanceDistance(
+	TEXT("MatFX.Significance.LowDistance"), 6000.0f,
+	TEXT("Distance from the view beyond which material effects skip animations and only write their final state"));
+
+static TAutoConsoleVariable<int32> CVarMatFXMediumUpdateInterval(
+	TEXT("MatFX.Significance.MediumUpdateInterval"), 3,
+	TEXT("Frames between updates of medium significance material effects"));
+
+static TAutoConsoleVariable<int32> CVarMatFXLowUpdateInterval(
+	TEXT("MatFX.Significance.LowUpdateInterval"), 10,
+	TEXT("Frames between updates of low significance material effects, also how late their handlers expire"));
+
+static TAutoConsoleVariable<float> CVarMatFXRecentlyRenderedTime(
+	TEXT("MatFX.Significance.RecentlyRenderedTime"), 0.2f,
+	TEXT("Actors not rendered within this many seconds run their material effects at low significance"));
+
+void UPVDMaterialEffectSubsystem::Deinitialize()
+{
+	for (UPVDMaterialEffectControllerComp* Controller : ActiveControllers)
+	{
+		if (Controller != nullptr)
+		{
+			Controller->bMaterialEffectsActive = false;
+		}
+	}
+	ActiveControllers.Reset();
+	UpdatedControllers.Reset();
+	Controllers.Reset();
+	MaterialInstancePools.Reset();
+	CompiledConfigsCache.Reset();
+	StressActors.Reset();
+
+	Super::Deinitialize();
+}
+
+void UPVDMaterialEffectSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	if (IsStressTestRunning())
+	{
+		TickStressTest(DeltaTime);
+	}
+
+	int32 NumParameterHandlers = 0;
+	int32 NumMaterialHandlers = 0;
+	uint64 PhaseCycles[4] = {0, 0, 0, 0};
+
+	if (!ActiveControllers.IsEmpty())
+	{
+		UpdateSignificance(DeltaTime);
+
+		uint64 StartCycles = FPlatformTime::Cycles64();
+
+		/** Game thread, material swaps run before parameter writes like the component tick did */
+		{
+			SCOPE_CYCLE_COUNTER(STAT_MatFXProcessMaterialsChanges);
+			CSV_SCOPED_TIMING_STAT(MatFX, ProcessMaterialsChanges);
+			for (UPVDMaterialEffectControllerComp* Controller : UpdatedControllers)
+			{
+				Controller->ProcessMaterialsChanges(Controller->PendingDeltaTime);
+			}
+		}
+		PhaseCycles[3] = FPlatformTime::Cycles64() - StartCycles;
+		StartCycles += PhaseCycles[3];
+
+		/** Game thread, finished handlers restore their values and priorities are resolved */
+		{
+			SCOPE_CYCLE_COUNTER(STAT_MatFXPrepareParameterChanges);
+			CSV_SCOPED_TIMING_STAT(MatFX, PrepareParameterChanges);
+			for (UPVDMaterialEffectControllerComp* Controller : UpdatedControllers)
+			{
+				Controller->PrepareParameterChanges();
+			}
+		}
+		PhaseCycles[0] = FPlatformTime::Cycles64() - StartCycles;
+		StartCycles += PhaseCycles[0];
+
+		/** Pure timing and curve time evaluation, touches no UObject */
+		{
+			SCOPE_CYCLE_COUNTER(STAT_MatFXAdvanceParameterTimings);
+			CSV_SCOPED_TIMING_STAT(MatFX, AdvanceParameterTimings);
+			ParallelFor(UpdatedControllers.Num(), [this](const int32 Index)
+			{
+				UpdatedControllers[Index]->AdvanceParameterChangeTimings(UpdatedControllers[Index]->PendingDeltaTime);
+			}, UpdatedControllers.Num() < MatFXParallelTimingThreshold);
+		}
+		PhaseCycles[1] = FPlatformTime::Cycles64() - StartCycles;
+		StartCycles += PhaseCycles[1];
+
+		/** Game thread, material writes */
+		{
+			SCOPE_CYCLE_COUNTER(STAT_MatFXApplyParameterChanges);
+			CSV_SCOPED_TIMING_STAT(MatFX, ApplyParameterChanges);
+			int32 NumTierWrites[3] = {0, 0, 0};
+			for (UPVDMaterialEffectControllerComp* Controller : UpdatedControllers)
+			{
+				NumTierWrites[static_cast<int32>(Controller->Significance)] += Controller->PendingParameterWrites.Num();
+				Controller->ApplyParameterChanges();
+				Controller->PendingDeltaTime = 0.0f;
+			}
+			SET_DWORD_STAT(STAT_MatFXHighSignificanceWrites, NumTierWrites[0]);
+			SET_DWORD_STAT(STAT_MatFXMediumSignificanceWrites, NumTierWrites[1]);
+			SET_DWORD_STAT(STAT_MatFXLowSignificanceWrites, NumTierWrites[2]);
+			CSV_CUSTOM_STAT(MatFX, HighSignificanceWrites, NumTierWrites[0], ECsvCustomStatOp::Set);
+			CSV_CUSTOM_STAT(MatFX, MediumSignificanceWrites, NumTierWrites[1], ECsvCustomStatOp::Set);
+			CSV_CUSTOM_STAT(MatFX, LowSignificanceWrites, NumTierWrites[2], ECsvCustomStatOp::Set);
+		}
+		PhaseCycles[2] = FPlatformTime::Cycles64() - StartCycles;
+
+
+		/** Idle controllers leave the batch */
+		for (int32 Index = ActiveControllers.Num() - 1; Index >= 0; --Index)
+		{
+			UPVDMaterialEffectControllerComp* Controller = ActiveControllers[Index];
+			NumParameterHandlers += Controller->GetNumParameterChangeHandlers();
+			NumMaterialHandlers += Controller->GetNumMaterialChangeHandlers();
+
+			if (!Controller->HasActiveHandlers())
+			{
+				Controller->bMaterialEffectsActive = false;
+				ActiveControllers.RemoveAtSwap(Index);
+			}
+		}
+	}
+
+	SET_DWORD_STAT(STAT_MatFXActiveControllers, ActiveControllers.Num());
+	SET_DWORD_STAT(STAT_MatFXParameterHandlers, NumParameterHandlers);
+	SET_DWORD_STAT(STAT_MatFXMaterialHandlers, NumMaterialHandlers);
+	SET_DWORD_STAT(STAT_MatFXMaterialInstancesCreated, NumMaterialInstancesCreated);
+	CSV_CUSTOM_STAT(MatFX, ActiveControllers, ActiveControllers.Num(), ECsvCustomStatOp::Set);
+	CSV_CUSTOM_STAT(MatFX, ParameterHandlers, NumParameterHandlers, ECsvCustomStatOp::Set);
+	CSV_CUSTOM_STAT(MatFX, MaterialHandlers, NumMaterialHandlers, ECsvCustomStatOp::Set);
+	CSV_CUSTOM_STAT(MatFX, MaterialInstancesCreated, NumMaterialInstancesCreated, ECsvCustomStatOp::Set);
+
+	if (IsStressTestRunning())
+	{
+		StressTotals.PrepareCycles += PhaseCycles[0];
+		StressTotals.AdvanceCycles += PhaseCycles[1];
+		StressTotals.ApplyCycles += PhaseCycles[2];
+		StressTotals.MaterialCycles += PhaseCycles[3];
+		StressTotals.NumFrames++;
+		StressTotals.PeakActiveControllers = FMath::Max(StressTotals.PeakActiveControllers, ActiveControllers.Num());
+		StressTotals.PeakParameterHandlers = FMath::Max(StressTotals.PeakParameterHandlers, NumParameterHandlers);
+		StressTotals.PeakMaterialHandlers = FMath::Max(StressTotals.PeakMaterialHandlers, NumMaterialHandlers);
+		StressTotals.MaterialInstancesCreated += NumMaterialInstancesCreated;
+	}
+
+	NumMaterialInstancesCreated = 0;
+}
+
+TStatId UPVDMaterialEffectSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UPVDMaterialEffectSubsystem, STATGROUP_Tickables);
+}
+
+void UPVDMaterialEffectSubsystem::UpdateSignificance(float DeltaTime)
+{
+	UpdatedControllers.Reset();
+
+	/**
+	 * Every local view counts, split screen players each keep the effects near them at full rate.
+	 * A dedicated server has no local player controller, so every controller stays at high significance there.
+	 */
+	TArray<FVector, TInlineAllocator<4>> ViewLocations;
+	TArray<const AActor*, TInlineAllocator<8>> ViewActors;
+	for (FConstPlayerControllerIterator It = GetWorld()->GetPlayerControllerIterator(); It; ++It)
+	{
+		const APlayerController* PlayerController = It->Get();
+		if (PlayerController == nullptr || !PlayerController->IsLocalController())
+			continue;
+
+		FVector ViewLocation;
+		FRotator ViewRotation;
+		PlayerController->GetPlayerViewPoint(ViewLocation, ViewRotation);
+		ViewLocations.Add(ViewLocation);
+		ViewActors.Add(PlayerController->GetPawn());
+		ViewActors.Add(PlayerController->GetViewTarget());
+	}
+
+	const float MediumDistanceSquared = FMath::Square(CVarMatFXMediumSignificanceDistance.GetValueOnGameThread());
+	const float LowDistanceSquared = FMath::Square(CVarMatFXLowSignificanceDistance.GetValueOnGameThread());
+	const float RecentlyRenderedTime = CVarMatFXRecentlyRenderedTime.GetValueOnGameThread();
+	/** Nothing is ever rendered without a renderer, -nullrhi or a headless client only ranks by distance */
+	const bool bCanEverRender = FApp::CanEverRender();
+	const int32 UpdateIntervals[3] = {
+		1,
+		FMath::Max(CVarMatFXMediumUpdateInterval.GetValueOnGameThread(), 1),
+		FMath::Max(CVarMatFXLowUpdateInterval.GetValueOnGameThread(), 1)
+	};
+
+	int32 NumTierControllers[3] = {0, 0, 0};
+	int32 NumSkippedUpdates = 0;
+
+	for (UPVDMaterialEffectControllerComp* Controller : ActiveControllers)
+	{
+		const AActor* Owner = Controller->GetOwner();
+		EMatFXSignificance Significance = EMatFXSignificance::High;
+
+		if (ViewLocations.Num() > 0 && Controller->bUseSignificance && Owner != nullptr && !ViewActors.Contains(Owner))
+		{
+			const FVector OwnerLocation = Owner->GetActorLocation();
+			float DistanceSquared = MAX_flt;
+			for (const FVector& ViewLocation : ViewLocations)
+			{
+				DistanceSquared = FMath::Min(DistanceSquared, FVector::DistSquared(OwnerLocation, ViewLocation));
+			}
+			if (DistanceSquared > LowDistanceSquared
+				|| (bCanEverRender && !Owner->WasRecentlyRendered(RecentlyRenderedTime)))
+			{
+				Significance = EMatFXSignificance::Low;
+			}
+			else if (DistanceSquared > MediumDistanceSquared)
+			{
+				Significance = EMatFXSignificance::Medium;
+			}
+		}
+
+		const int32 Tier = static_cast<int32>(Significance);
+		Controller->Significance = Significance;
+		/** Component ticks received the owner's dilated time, effects of slowed or sped up actors keep that pace */
+		Controller->PendingDeltaTime += Owner != nullptr ? DeltaTime * Owner->CustomTimeDilation : DeltaTime;
+		++NumTierControllers[Tier];
+
+		/** Unique id spreads the controllers of a tier over the frames of its interval */
+		if ((GFrameCounter + Controller->GetUniqueID()) % UpdateIntervals[Tier] == 0)
+		{
+			UpdatedControllers.Add(Controller);
+		}
+		else
+		{
+			++NumSkippedUpdates;
+		}
+	}
+
+	SET_DWORD_STAT(STAT_MatFXHighSignificanceControllers, NumTierControllers[0]);
+	SET_DWORD_STAT(STAT_MatFXMediumSignificanceControllers, NumTierControllers[1]);
+	SET_DWORD_STAT(STAT_MatFXLowSignificanceControllers, NumTierControllers[2]);
+	SET_DWORD_STAT(STAT_MatFXSkippedControllerUpdates, NumSkippedUpdates);
+	CSV_CUSTOM_STAT(MatFX, HighSignificanceControllers, NumTierControllers[0], ECsvCustomStatOp::Set);
+	CSV_CUSTOM_STAT(MatFX, MediumSignificanceControllers, NumTierControllers[1], ECsvCustomStatOp::Set);
+	CSV_CUSTOM_STAT(MatFX, LowSignificanceControllers, NumTierControllers[2], ECsvCustomStatOp::Set);
+	CSV_CUSTOM_STAT(MatFX, SkippedControllerUpdates, NumSkippedUpdates, ECsvCustomStatOp::Set);
+}
+
+void UPVDMaterialEffectSubsystem::RegisterController(UPVDMaterialEffectControllerComp* Controller)
+{
+	Controllers.AddUnique(Controller);
+}
+
+void UPVDMaterialEffectSubsystem::UnregisterController(UPVDMaterialEffectControllerComp* Controller)
+{
+	Controllers.RemoveSwap(Controller);
+
+	if (Controller->bMaterialEffectsActive)
+	{
+		Controller->bMaterialEffectsActive = false;
+		ActiveControllers.RemoveSwap(Controller);
+	}
+
+	/** A shared set leaves the cache with its last controller instead of outliving its data assets */
+	if (Controller->CompiledConfigs.IsValid())
+	{
+		const FMatFXCompiledConfigs* ReleasedConfigs = Controller->CompiledConfigs.Get();
+		Controller->CompiledConfigs.Reset();
+
+		for (auto It = CompiledConfigsCache.CreateIterator(); It; ++It)
+		{
+			if (&It.Value().CompiledConfigs.Get() == ReleasedConfigs)
+			{
+				/** The cache holds one reference itself */
+				if (It.Value().CompiledConfigs.GetSharedReferenceCount() == 1)
+				{
+					It.RemoveCurrent();
+				}
+				break;
+			}
+		}
+	}
+}
+
+void UPVDMaterialEffectSubsystem::ActivateController(UPVDMaterialEffectControllerComp* Controller)
+{
+	if (!Controller->bMaterialEffectsActive)
+	{
+		Controller->bMaterialEffectsActive = true;
+		Controller->PendingDeltaTime = 0.0f;
+		ActiveControllers.Add(Controller);
+	}
+}
+
+UMaterialInstanceDynamic* UPVDMaterialEffectSubsystem::LeaseMaterialInstance(UMaterialInterface* BaseMaterial)
+{
+	FMatFXMaterialInstancePool& Pool = MaterialInstancePools.FindOrAdd(BaseMaterial);
+	if (Pool.FreeInstances.Num() > 0)
+	{
+		return Pool.FreeInstances.Pop(false);
+	}
+
+	UMaterialInstanceDynamic* MaterialInstance = UMaterialInstanceDynamic::Create(BaseMaterial, this);
+	Pool.Instances.Add(MaterialInstance);
+	NotifyMaterialInstanceCreated();
+	return MaterialInstance;
+}
+
+void UPVDMaterialEffectSubsystem::ReturnMaterialInstance(UMaterialInterface* BaseMaterial,
+                                                         UMaterialInstanceDynamic* MaterialInstance)
+{
+	FMatFXMaterialInstancePool* Pool = MaterialInstancePools.Find(BaseMaterial);
+	if (Pool == nullptr)
+		return;
+
+	MaterialInstance->ClearParameterValues();
+	Pool->FreeInstances.Add(MaterialInstance);
+}
+
+void UPVDMaterialEffectSubsystem::ReportMaterialInstanceMemory(FOutputDevice& Ar) const
+{
+	int32 NumLeasingControllers = 0;
+	int32 NumPersistentInstances = 0;
+	SIZE_T PersistentBytes = 0;
+	int32 NumLeasedChannels = 0;
+
+	for (const UPVDMaterialEffectControllerComp* Controller : Controllers)
+	{
+		if (Controller->bLeaseMaterialInstances)
+		{
+			++NumLeasingControllers;
+			for (const FParameterChangeChannel& Channel : Controller->ParameterChangeChannels)
+			{
+				NumLeasedChannels += Channel.bHasLeased ? 1 : 0;
+			}
+		}
+
+		for (const TWeakObjectPtr<UMaterialInstanceDynamic>& MaterialInstance : Controller->OwnedMaterialInstances)
+		{
+			if (MaterialInstance.IsValid())
+			{
+				++NumPersistentInstances;
+				PersistentBytes += MaterialInstance->GetResourceSizeBytes(EResourceSizeMode::EstimatedTotal);
+			}
+		}
+	}
+
+	int32 NumPooledInstances = 0;
+	int32 NumFreeInstances = 0;
+	SIZE_T PooledBytes = 0;
+
+	for (const TPair<TObjectPtr<UMaterialInterface>, FMatFXMaterialInstancePool>& Pair : MaterialInstancePools)
+	{
+		NumPooledInstances += Pair.Value.Instances.Num();
+		NumFreeInstances += Pair.Value.FreeInstances.Num();
+		/** GetResourceSizeBytes is not const, TObjectPtr hands out a mutable pointer from the const pool */
+		for (UMaterialInstanceDynamic* MaterialInstance : Pair.Value.Instances)
+		{
+			PooledBytes += MaterialInstance->GetResourceSizeBytes(EResourceSizeMode::EstimatedTotal);
+		}
+	}
+
+	/** A leasing controller would otherwise keep one instance per slot an effect ever touched */
+	const SIZE_T AverageInstanceBytes = NumPooledInstances > 0 ? PooledBytes / NumPooledInstances : 0;
+
+	Ar.Logf(TEXT("MatFX material instances, %d controllers, %d leasing"), Controllers.Num(), NumLeasingControllers);
+	Ar.Logf(TEXT("  Persistent: %d instances, %.1f KB"), NumPersistentInstances, PersistentBytes / 1024.0f);
+	Ar.Logf(TEXT("  Pooled: %d instances over %d materials, %d leased, %d free, %.1f KB"),
+		NumPooledInstances, MaterialInstancePools.Num(), NumPooledInstances - NumFreeInstances, NumFreeInstances, PooledBytes / 1024.0f);
+	Ar.Logf(TEXT("  Leasing controllers without pooling: %d instances, about %.1f KB"),
+		NumLeasedChannels, NumLeasedChannels * AverageInstanceBytes / 1024.0f);
+}
+
+TSharedRef<const FMatFXCompiledConfigs> UPVDMaterialEffectSubsystem::FindOrCompileConfigs(
+	const TArray<UMaterialEffectConfigDataAsset*>& DataAssets)
+{
+	TArray<TObjectKey<UMaterialEffectConfigDataAsset>> DataAssetKeys;
+	uint32 Hash = 0;
+	for (const UMaterialEffectConfigDataAsset* DataAsset : DataAssets)
+	{
+		DataAssetKeys.Add(DataAsset);
+		Hash = HashCombine(Hash, GetTypeHash(DataAssetKeys.Last()));
+	}
+
+	TArray<const FCompiledConfigsEntry*> Entries;
+	CompiledConfigsCache.MultiFindPointer(Hash, Entries);
+	for (const FCompiledConfigsEntry* Entry : Entries)
+	{
+		if (Entry->DataAssets == DataAssetKeys)
+		{
+			return Entry->CompiledConfigs;
+		}
+	}
+
+	TArray<const FMaterialEffectConfig*> SourceConfigs;
+	for (const UMaterialEffectConfigDataAsset* DataAsset : DataAssets)
+	{
+		for (const FMaterialEffectConfig& Config : DataAsset->ConfigList)
+		{
+			SourceConfigs.Add(&Config);
+		}
+	}
+
+	const TSharedRef<FMatFXCompiledConfigs> CompiledConfigs = MakeShared<FMatFXCompiledConfigs>();
+	CompiledConfigs->Build(SourceConfigs);
+	CompiledConfigsCache.Add(Hash, FCompiledConfigsEntry{MoveTemp(DataAssetKeys), CompiledConfigs});
+	return CompiledConfigs;
+}
+
+void UPVDMaterialEffectSubsystem::ReportCompiledConfigMemory(FOutputDevice& Ar) const
+{
+	SIZE_T SharedBytes = 0;
+	SIZE_T PerControllerBytes = 0;
+	int32 NumSharingControllers = 0;
+
+	for (const TPair<uint32, FCompiledConfigsEntry>& Pair : CompiledConfigsCache)
+	{
+		const SIZE_T Bytes = Pair.Value.CompiledConfigs->GetAllocatedSize();
+		/** The cache holds one reference itself */
+		const int32 NumUsers = Pair.Value.CompiledConfigs.GetSharedReferenceCount() - 1;
+		SharedBytes += Bytes;
+		PerControllerBytes += Bytes * NumUsers;
+		NumSharingControllers += NumUsers;
+	}
+
+	Ar.Logf(TEXT("MatFX compiled configs, %d shared sets used by %d controllers"), CompiledConfigsCache.Num(), NumSharingControllers);
+	Ar.Logf(TEXT("  Shared: %.1f KB, one copy per controller: %.1f KB"), SharedBytes / 1024.0f, PerControllerBytes / 1024.0f);
+}
+
+void UPVDMaterialEffectSubsystem::StartStressTest(TSubclassOf<AActor> ActorClass, int32 NumActors,
+                                                  float EmissionsPerSecond, const TArray<EMatFXGlobalEvent>& Events)
+{
+	StopStressTest(*GLog);
+
+	if (ActorClass == nullptr || NumActors <= 0 || EmissionsPerSecond <= 0.0f || Events.IsEmpty())
+		return;
+
+	UWorld* World = GetWorld();
+	const int32 GridSize = FMath::CeilToInt(FMath::Sqrt(static_cast<float>(NumActors)));
+	constexpr float GridSpacing = 300.0f;
+
+	FActorSpawnParameters SpawnParameters;
+	SpawnParameters.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+
+	for (int32 Index = 0; Index < NumActors; ++Index)
+	{
+		const FVector Location((Index % GridSize) * GridSpacing, (Index / GridSize) * GridSpacing, 0.0f);
+		if (AActor* Actor = World->SpawnActor<AActor>(ActorClass, Location, FRotator::ZeroRotator, SpawnParameters))
+		{
+			StressActors.Add(Actor);
+		}
+	}
+
+	StressEvents = Events;
+	StressEmissionInterval = 1.0f / EmissionsPerSecond;
+	StressEmissionAccumulator = 0.0f;
+	StressEventIndex = 0;
+	StressTotals = FMatFXStressTotals();
+}
+
+void UPVDMaterialEffectSubsystem::StopStressTest(FOutputDevice& Ar)
+{
+	if (!IsStressTestRunning())
+		return;
+
+	const int32 NumFrames = FMath::Max(StressTotals.NumFrames, 1);
+	const double MillisecondsPerCycle = FPlatformTime::GetSecondsPerCycle64() * 1000.0;
+
+	Ar.Logf(TEXT("MatFX stress test, %d actors, %d frames, %d emissions"),
+		StressActors.Num(), StressTotals.NumFrames, StressTotals.NumEmissions);
+	Ar.Logf(TEXT("  Per frame ms: prepare %.3f, advance %.3f, apply %.3f, materials %.3f"),
+		StressTotals.PrepareCycles * MillisecondsPerCycle / NumFrames,
+		StressTotals.AdvanceCycles * MillisecondsPerCycle / NumFrames,
+		StressTotals.ApplyCycles * MillisecondsPerCycle / NumFrames,
+		StressTotals.MaterialCycles * MillisecondsPerCycle / NumFrames);
+	Ar.Logf(TEXT("  Peak: %d active controllers, %d parameter handlers, %d material handlers"),
+		StressTotals.PeakActiveControllers, StressTotals.PeakParameterHandlers, StressTotals.PeakMaterialHandlers);
+	Ar.Logf(TEXT("  Material instances created: %d"), StressTotals.MaterialInstancesCreated);
+	ReportMaterialInstanceMemory(Ar);
+
+	for (AActor* Actor : StressActors)
+	{
+		if (IsValid(Actor))
+		{
+			Actor->Destroy();
+		}
+	}
+	StressActors.Reset();
+	StressEvents.Reset();
+}
+
+void UPVDMaterialEffectSubsystem::TickStressTest(float DeltaTime)
+{
+	StressEmissionAccumulator += DeltaTime;
+
+	/** Every actor gets the next event of the stream once per interval, a long hitch does not burst emissions */
+	if (StressEmissionAccumulator < StressEmissionInterval)
+		return;
+	StressEmissionAccumulator = FMath::Fmod(StressEmissionAccumulator, StressEmissionInterval);
+
+	const EMatFXGlobalEvent Event = StressEvents[StressEventIndex];
+	StressEventIndex = (StressEventIndex + 1) % StressEvents.Num();
+
+	for (AActor* Actor : StressActors)
+	{
+		if (IsValid(Actor))
+		{
+			GES_MATERIAL_EFFECT_EMIT(Event, Actor);
+			StressTotals.NumEmissions++;
+		}
+	}
+}
+
+static FAutoConsoleCommandWithWorldAndArgs MatFXStressStartCommand(
+	TEXT("MatFX.Stress.Start"),
+	TEXT("MatFX.Stress.Start <ActorClassPath> <NumActors> <EmissionsPerSecond> <Event> [<Event>...], ")
+	TEXT("spawns actors and emits the material effect events on each of them at the given rate"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+	{
+		UPVDMaterialEffectSubsystem* MaterialEffectSubsystem = World != nullptr ? World->GetSubsystem<UPVDMaterialEffectSubsystem>() : nullptr;
+		if (MaterialEffectSubsystem == nullptr || Args.Num() < 4)
+		{
+			GLog->Log(TEXT("MatFX.Stress.Start <ActorClassPath> <NumActors> <EmissionsPerSecond> <Event> [<Event>...]"));
+			return;
+		}
+
+		UClass* ActorClass = LoadClass<AActor>(nullptr, *Args[0]);
+		if (ActorClass == nullptr)
+		{
+			GLog->Logf(TEXT("MatFX.Stress.Start: no actor class at %s"), *Args[0]);
+			return;
+		}
+
+		TArray<EMatFXGlobalEvent> Events;
+		const UEnum* EventEnum = StaticEnum<EMatFXGlobalEvent>();
+		for (int32 Index = 3; Index < Args.Num(); ++Index)
+		{
+			const int64 Value = EventEnum->GetValueByNameString(Args[Index]);
+			if (Value == INDEX_NONE)
+			{
+				GLog->Logf(TEXT("MatFX.Stress.Start: unknown event %s"), *Args[Index]);
+				return;
+			}
+			Events.Add(static_cast<EMatFXGlobalEvent>(Value));
+		}
+
+		MaterialEffectSubsystem->StartStressTest(ActorClass, FCString::Atoi(*Args[1]), FCString::Atof(*Args[2]), Events);
+	}));
+
+static FAutoConsoleCommandWithWorldAndArgs MatFXStressStopCommand(
+	TEXT("MatFX.Stress.Stop"),
+	TEXT("Destroys the stress test actors and logs per frame batch tick cost, handler and material instance counts"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+	{
+		if (UPVDMaterialEffectSubsystem* MaterialEffectSubsystem = World != nullptr ? World->GetSubsystem<UPVDMaterialEffectSubsystem>() : nullptr)
+		{
+			MaterialEffectSubsystem->StopStressTest(*GLog);
+		}
+	}));
+
+static FAutoConsoleCommandWithWorldAndArgs MatFXMaterialInstanceReportCommand(
+	TEXT("MatFX.MaterialInstanceReport"),
+	TEXT("Logs material effect instance counts and memory, persistent against leased"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+	{
+		if (const UPVDMaterialEffectSubsystem* MaterialEffectSubsystem = World != nullptr ? World->GetSubsystem<UPVDMaterialEffectSubsystem>() : nullptr)
+		{
+			MaterialEffectSubsystem->ReportMaterialInstanceMemory(*GLog);
+		}
+	}));
+
+static FAutoConsoleCommandWithWorldAndArgs MatFXCompiledConfigReportCommand(
+	TEXT("MatFX.CompiledConfigReport"),
+	TEXT("Logs memory of shared compiled material effect configs against one copy per controller"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+	{
+		if (const UPVDMaterialEffectSubsystem* MaterialEffectSubsystem = World != nullptr ? World->GetSubsystem<UPVDMaterialEffectSubsystem>() : nullptr)
+		{
+			MaterialEffectSubsystem->ReportCompiledConfigMemory(*GLog);
+		}
+	}));
@@ -0,0 +1,139 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "PVDMaterialEffectSubsystem.generated.h"
+
+class UPVDMaterialEffectControllerComp;
+class UMaterialEffectConfigDataAsset;
+struct FMatFXCompiledConfigs;
+enum class EMatFXGlobalEvent : uint8;
+
+DECLARE_STATS_GROUP(TEXT("MatFX"), STATGROUP_MatFX, STATCAT_Advanced);
+
+/** Dynamic material instances of one base material shared by leasing controllers */
+USTRUCT()
+struct FMatFXMaterialInstancePool
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	TArray<TObjectPtr<UMaterialInstanceDynamic>> Instances;
+
+	UPROPERTY()
+	TArray<TObjectPtr<UMaterialInstanceDynamic>> FreeInstances;
+};
+
+/** Batch tick totals over a stress run */
+struct FMatFXStressTotals
+{
+	uint64 PrepareCycles = 0;
+	uint64 AdvanceCycles = 0;
+	uint64 ApplyCycles = 0;
+	uint64 MaterialCycles = 0;
+	int32 NumFrames = 0;
+	int32 NumEmissions = 0;
+	int32 PeakActiveControllers = 0;
+	int32 PeakParameterHandlers = 0;
+	int32 PeakMaterialHandlers = 0;
+	int32 MaterialInstancesCreated = 0;
+};
+
+/**
+ * Ticks every material effect controller of the world in one batch instead of one component tick per actor.
+ * Only controllers with running handlers are visited, their timing pass runs across worker threads and
+ * everything touching materials, meshes or GES stays on the game thread. Controllers far from every local
+ * player's view or not rendered lately get a lower significance tier and update less often.
+ */
+UCLASS()
+class PVD_API UPVDMaterialEffectSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Deinitialize() override;
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	void RegisterController(UPVDMaterialEffectControllerComp* Controller);
+
+	/** Also releases the controller's compiled configs, evicting them from the cache when no other controller uses them */
+	void UnregisterController(UPVDMaterialEffectControllerComp* Controller);
+
+	/** Called by controllers when they create handlers, keeps them in the tick batch until they are idle again */
+	void ActivateController(UPVDMaterialEffectControllerComp* Controller);
+
+	int32 GetNumRegisteredControllers() const { return Controllers.Num(); }
+
+	int32 GetNumActiveControllers() const { return ActiveControllers.Num(); }
+
+	UMaterialInstanceDynamic* LeaseMaterialInstance(UMaterialInterface* BaseMaterial);
+
+	/** Parameter overrides are cleared so the next lease starts from the base material values */
+	void ReturnMaterialInstance(UMaterialInterface* BaseMaterial, UMaterialInstanceDynamic* MaterialInstance);
+
+	/** Material instance count and memory of persistent instances against leased ones */
+	void ReportMaterialInstanceMemory(FOutputDevice& Ar) const;
+
+	/** Compiles each distinct data asset list once, controllers using the same assets share it while any of them is registered */
+	TSharedRef<const FMatFXCompiledConfigs> FindOrCompileConfigs(const TArray<UMaterialEffectConfigDataAsset*>& DataAssets);
+
+	/** Compiled config memory, shared against what one copy per controller would take */
+	void ReportCompiledConfigMemory(FOutputDevice& Ar) const;
+
+	/** Counts material instances created outside the pool, feeds the stats and the stress report */
+	void NotifyMaterialInstanceCreated() { ++NumMaterialInstancesCreated; }
+
+	/**
+	 * Spawns actors of the given class on a grid and emits the events in turn on all of them at the given rate.
+	 * Runs until StopStressTest, which destroys the actors and logs the batch tick cost.
+	 */
+	void StartStressTest(TSubclassOf<AActor> ActorClass, int32 NumActors, float EmissionsPerSecond,
+	                     const TArray<EMatFXGlobalEvent>& Events);
+
+	void StopStressTest(FOutputDevice& Ar);
+
+	bool IsStressTestRunning() const { return StressActors.Num() > 0; }
+
+	/** Spawned by StartStressTest, callers may add components to them before the first emission */
+	const TArray<TObjectPtr<AActor>>& GetStressActors() const { return StressActors; }
+
+private:
+	/** Gives every active controller its tier and collects the ones updating this frame into UpdatedControllers */
+	void UpdateSignificance(float DeltaTime);
+
+	void TickStressTest(float DeltaTime);
+
+	UPROPERTY()
+	TArray<TObjectPtr<UPVDMaterialEffectControllerComp>> Controllers;
+
+	UPROPERTY()
+	TArray<TObjectPtr<UPVDMaterialEffectControllerComp>> ActiveControllers;
+
+	/** Subset of ActiveControllers updating this frame, rebuilt every tick */
+	TArray<UPVDMaterialEffectControllerComp*> UpdatedControllers;
+
+	UPROPERTY()
+	TMap<TObjectPtr<UMaterialInterface>, FMatFXMaterialInstancePool> MaterialInstancePools;
+
+	/** Object keys so an entry can never match a new asset allocated where an unloaded one was */
+	struct FCompiledConfigsEntry
+	{
+		TArray<TObjectKey<UMaterialEffectConfigDataAsset>> DataAssets;
+		TSharedRef<const FMatFXCompiledConfigs> CompiledConfigs;
+	};
+
+	TMultiMap<uint32, FCompiledConfigsEntry> CompiledConfigsCache;
+
+	/** Since the last tick */
+	int32 NumMaterialInstancesCreated = 0;
+
+	UPROPERTY()
+	TArray<TObjectPtr<AActor>> StressActors;
+
+	TArray<EMatFXGlobalEvent> StressEvents;
+	float StressEmissionInterval = 0.0f;
+	float StressEmissionAccumulator = 0.0f;
+	int32 StressEventIndex = 0;
+	FMatFXStressTotals StressTotals;
+};
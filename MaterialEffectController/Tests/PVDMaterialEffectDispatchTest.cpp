@@ -0,0 +1,50 @@
+#include "PVDMaterialEffectTestUtils.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "GESHandler.h"
+#include "Misc/AutomationTest.h"
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FPVDMaterialEffectDispatchOncePerEmissionTest, "MatFX.Dispatch.ConfigsRunOncePerEmission",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext | EAutomationTestFlags::EngineFilter)
+
+/** Configs sharing an event each run once per emission, a listener per config used to run the whole list again */
+bool FPVDMaterialEffectDispatchOncePerEmissionTest::RunTest(const FString& Parameters)
+{
+	constexpr int32 NumConfigs = 5;
+	constexpr EMatFXGlobalEvent TestEvent = EMatFXGlobalEvent::MatFX_EnemyTakeDamage;
+	constexpr EMatFXGlobalEvent OtherEvent = EMatFXGlobalEvent::MatFx_EnemyTargeted;
+
+	UWorld* World = MatFXTest::CreateWorld();
+	AActor* Actor = World->SpawnActor<AActor>();
+
+	TArray<FMaterialEffectConfig> Configs;
+	for (int32 Index = 0; Index < NumConfigs; ++Index)
+	{
+		Configs.Add(MatFXTest::MakeParameterConfig(TestEvent, *FString::Printf(TEXT("Param%d"), Index), 10.0f));
+	}
+	Configs.Add(MatFXTest::MakeParameterConfig(OtherEvent, TEXT("Other"), 10.0f));
+
+	const UPVDMaterialEffectControllerComp* Controller = MatFXTest::AddController(Actor, Configs);
+	TestEqual(TEXT("No handler before any emission"), Controller->GetNumParameterChangeHandlers(), 0);
+
+	GES_MATERIAL_EFFECT_EMIT(TestEvent, Actor);
+	TestEqual(TEXT("One handler per config after one emission"), Controller->GetNumParameterChangeHandlers(), NumConfigs);
+
+	/** Stacking is unlimited by default, a second emission adds exactly one more handler per config */
+	GES_MATERIAL_EFFECT_EMIT(TestEvent, Actor);
+	TestEqual(TEXT("One more handler per config after a second emission"), Controller->GetNumParameterChangeHandlers(), 2 * NumConfigs);
+
+	GES_MATERIAL_EFFECT_EMIT(OtherEvent, Actor);
+	TestEqual(TEXT("Another event only runs its own config"), Controller->GetNumParameterChangeHandlers(), 2 * NumConfigs + 1);
+
+	/** Emissions for another actor do not reach this controller */
+	AActor* OtherActor = World->SpawnActor<AActor>();
+	GES_MATERIAL_EFFECT_EMIT(TestEvent, OtherActor);
+	TestEqual(TEXT("Emission on another actor runs nothing here"), Controller->GetNumParameterChangeHandlers(), 2 * NumConfigs + 1);
+
+	MatFXTest::DestroyWorld(World);
+	return true;
+}
+
+#endif
@@ -0,0 +1,104 @@
+#include "PVDMaterialEffectTestUtils.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "../PVDMaterialEffectSubsystem.h"
+#include "Misc/AutomationTest.h"
+
+/**
+ * Fixed stress run for CI, headless builds run it with -nullrhi -ExecCmds="Automation RunTests MatFX".
+ * The subsystem logs per frame batch tick cost, handler peaks and material instance counts when it stops,
+ * compare those lines between runs to spot regressions.
+ */
+namespace MatFXStressTest
+{
+	constexpr int32 NumActors = 200;
+	constexpr int32 NumMeshesPerActor = 4;
+	constexpr float EmissionsPerSecond = 10.0f;
+	constexpr int32 NumFrames = 300;
+	constexpr float FrameTime = 1.0f / 60.0f;
+}
+
+/** Ticks the test world one fixed step per engine frame, the engine does not tick worlds it did not create */
+class FMatFXTickWorldCommand : public IAutomationLatentCommand
+{
+public:
+	FMatFXTickWorldCommand(UWorld* InWorld, const int32 InNumFrames, const float InFrameTime)
+		: World(InWorld), NumFrames(InNumFrames), FrameTime(InFrameTime)
+	{
+	}
+
+	virtual bool Update() override
+	{
+		World->Tick(LEVELTICK_All, FrameTime);
+		return ++Frame >= NumFrames;
+	}
+
+private:
+	UWorld* World;
+	int32 NumFrames;
+	float FrameTime;
+	int32 Frame = 0;
+};
+
+DEFINE_LATENT_AUTOMATION_COMMAND_ONE_PARAMETER(FMatFXStopStressTestCommand, UWorld*, World);
+
+bool FMatFXStopStressTestCommand::Update()
+{
+	if (UPVDMaterialEffectSubsystem* MaterialEffectSubsystem = World->GetSubsystem<UPVDMaterialEffectSubsystem>())
+	{
+		MaterialEffectSubsystem->StopStressTest(*GLog);
+	}
+	MatFXTest::DestroyWorld(World);
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FPVDMaterialEffectStressTest, "MatFX.Stress.HitFlashOutlineElemental",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext | EAutomationTestFlags::PerfFilter)
+
+/** Hit flashes, targeted outlines and elemental hits emitted in turn on every actor */
+bool FPVDMaterialEffectStressTest::RunTest(const FString& Parameters)
+{
+	using namespace MatFXStressTest;
+
+	UWorld* World = MatFXTest::CreateWorld();
+	UPVDMaterialEffectSubsystem* MaterialEffectSubsystem = World->GetSubsystem<UPVDMaterialEffectSubsystem>();
+	if (!TestNotNull(TEXT("Material effect subsystem"), MaterialEffectSubsystem))
+	{
+		MatFXTest::DestroyWorld(World);
+		return false;
+	}
+
+	const TArray<EMatFXGlobalEvent> Events = {
+		EMatFXGlobalEvent::MatFX_EnemyTakeDamage,
+		EMatFXGlobalEvent::MatFx_EnemyTargeted,
+		EMatFXGlobalEvent::MatFX_ElementalLightHit
+	};
+
+	TArray<FMaterialEffectConfig> Configs;
+	Configs.Add(MatFXTest::MakeParameterConfig(EMatFXGlobalEvent::MatFX_EnemyTakeDamage, TEXT("HitFlash"), 0.2f));
+	Configs.Add(MatFXTest::MakeParameterConfig(EMatFXGlobalEvent::MatFx_EnemyTargeted, TEXT("Outline"), 1.0f));
+	Configs.Add(MatFXTest::MakeParameterConfig(EMatFXGlobalEvent::MatFX_ElementalLightHit, TEXT("ElementalLight"), 0.5f));
+
+	MaterialEffectSubsystem->StartStressTest(AActor::StaticClass(), NumActors, EmissionsPerSecond, Events);
+	if (!TestEqual(TEXT("Stress actors spawned"), MaterialEffectSubsystem->GetStressActors().Num(), NumActors))
+	{
+		MaterialEffectSubsystem->StopStressTest(*GLog);
+		MatFXTest::DestroyWorld(World);
+		return false;
+	}
+
+	for (AActor* Actor : MaterialEffectSubsystem->GetStressActors())
+	{
+		MatFXTest::AddController(Actor, Configs, NumMeshesPerActor);
+	}
+
+	AddInfo(FString::Printf(TEXT("%d actors, %d meshes each, %.1f emissions per second, %d frames of %.4f s"),
+		NumActors, NumMeshesPerActor, EmissionsPerSecond, NumFrames, FrameTime));
+
+	ADD_LATENT_AUTOMATION_COMMAND(FMatFXTickWorldCommand(World, NumFrames, FrameTime));
+	ADD_LATENT_AUTOMATION_COMMAND(FMatFXStopStressTestCommand(World));
+	return true;
+}
+
+#endif
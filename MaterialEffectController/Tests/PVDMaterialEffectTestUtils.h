@@ -0,0 +1,86 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "Components/StaticMeshComponent.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "Materials/Material.h"
+#include "../PVDMaterialEffectControllerComp.h"
+
+/** Game world and actors for material effect automation tests, nothing here is loaded from content */
+namespace MatFXTest
+{
+	/** Begun play, tick it by hand, the engine does not tick worlds it did not create */
+	inline UWorld* CreateWorld()
+	{
+		UWorld* World = UWorld::CreateWorld(EWorldType::Game, false);
+		FWorldContext& WorldContext = GEngine->CreateNewWorldContext(EWorldType::Game);
+		WorldContext.SetCurrentWorld(World);
+
+		World->InitializeActorsForPlay(FURL());
+		World->BeginPlay();
+
+		/** Without a game mode nothing starts play, actors spawned afterwards would never begin play */
+		if (!World->GetBegunPlay())
+		{
+			World->GetWorldSettings()->NotifyBeginPlay();
+		}
+		return World;
+	}
+
+	inline void DestroyWorld(UWorld* World)
+	{
+		GEngine->DestroyWorldContext(World);
+		World->DestroyWorld(false);
+	}
+
+	/** Scalar change on the overlay slot of every mesh, one target per mesh even without a static mesh asset */
+	inline FMaterialEffectConfig MakeParameterConfig(const EMatFXGlobalEvent Event, const FName ParameterName,
+	                                                 const float Lifetime)
+	{
+		FMaterialParameterChangeConfig ParameterConfig = FMaterialParameterChangeConfig();
+		ParameterConfig.ParameterName = ParameterName;
+		ParameterConfig.ParameterType = EMaterialParamType::Float;
+		ParameterConfig.ParameterChangeType = EMaterialParameterChangeType::Override;
+		ParameterConfig.FloatParameterValue = 1.0f;
+		ParameterConfig.HasLifetime = true;
+		ParameterConfig.Lifetime = Lifetime;
+
+		FMaterialEffectConfig Config = FMaterialEffectConfig();
+		Config.GlobalEventType = Event;
+		Config.MaterialEffectType = EMaterialEffectType::ChangeParameters;
+		Config.EffectAllMeshes = true;
+		Config.IsOverlaySlot = true;
+		Config.ParameterConfigs.Add(ParameterConfig);
+		return Config;
+	}
+
+	/**
+	 * Adds meshes and a controller running Configs to an actor that has begun play, the controller begins play too.
+	 * Meshes get the engine default material as overlay so overlay effects have a real base material.
+	 */
+	inline UPVDMaterialEffectControllerComp* AddController(AActor* Actor, const TArray<FMaterialEffectConfig>& Configs,
+	                                                       const int32 NumMeshes = 1)
+	{
+		for (int32 Index = 0; Index < NumMeshes; ++Index)
+		{
+			UStaticMeshComponent* MeshComponent = NewObject<UStaticMeshComponent>(Actor);
+			if (Actor->GetRootComponent() == nullptr)
+			{
+				Actor->SetRootComponent(MeshComponent);
+			}
+			MeshComponent->SetOverlayMaterial(UMaterial::GetDefaultMaterial(MD_Surface));
+			MeshComponent->RegisterComponent();
+		}
+
+		UPVDMaterialEffectControllerComp* Controller = NewObject<UPVDMaterialEffectControllerComp>(Actor);
+		Controller->Configs = Configs;
+		Controller->RegisterComponent();
+		return Controller;
+	}
+}
+
+#endif